@@ -0,0 +1,101 @@
+#include "benchmarks.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+#include "../include/token_parser/settings.h"
+
+BENCHMARK_MAIN();
+
+std::string BenchTmpFilename(const std::string& name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::string BenchSpacesCorpus(std::size_t size) {
+  const std::string kIndent = "\n\t\t        \t  ";
+  std::string str;
+  for (std::size_t i = 0; str.size() < size; ++i) {
+    str += kIndent.substr(0, 2 + i % (kIndent.size() - 2));
+    str += "word";
+    str += std::to_string(i % 97);
+  }
+  return str;
+}
+
+std::string BenchLongRunsCorpus(std::size_t size) {
+  std::string str;
+  for (std::size_t i = 0; str.size() < size; ++i) {
+    str += std::string(24 + i % 40, i % 2 ? ' ' : '\t');
+    str += std::string(40 + i % 80, static_cast<char>('a' + i % 26));
+    str += '\n';
+  }
+  return str;
+}
+
+std::string BenchQuotedBlobCorpus(std::size_t size) {
+  std::string str = "key = '";
+  for (std::size_t i = 0; str.size() < size; ++i) {
+    str += "line of the quoted value ";
+    str += std::to_string(i);
+    str += '\n';
+  }
+  str += "' end\n";
+  return str;
+}
+
+std::string BenchIntsCorpus(std::size_t size) {
+  std::string str;
+  for (std::size_t i = 0; str.size() < size; ++i) {
+    long long value = static_cast<long long>(i * 2654435761u % 100000007u);
+    if (i % 3 == 0) value = -value;
+    str += std::to_string(value >> (i % 20));
+    str += ' ';
+  }
+  return str;
+}
+
+std::string BenchFloatsCorpus(std::size_t size) {
+  std::string str;
+  for (std::size_t i = 0; str.size() < size; ++i) {
+    str += std::to_string(i * 2654435761u % 100000007u);
+    str += i % 2 ? "." : "e-";
+    str += std::to_string(i % 1000);
+    str += ' ';
+  }
+  return str;
+}
+
+TokenParser::Settings::TokenIds BenchTokenIds(std::size_t count) {
+  TokenParser::Settings::TokenIds token_ids = {
+      {0, "("}, {1, ")"}, {2, ";"}, {3, "="}};
+  for (std::size_t i = 0; i < count; ++i)
+    token_ids.insert({token_ids.size(), "kw" + std::to_string(i)});
+  return token_ids;
+}
+
+std::string BenchKeywordsCorpus(std::size_t size, std::size_t ids_count) {
+  std::string str;
+  for (std::size_t i = 0; str.size() < size; ++i) {
+    std::size_t id = i * 2654435761u % ids_count;
+    str += "kw" + std::to_string(id) + " ( ";
+    str += "name" + std::to_string(i % 13) + " = ";
+    str += std::to_string(i % 1000) + " ) ;";
+    str += i % 4 ? " " : "\n";
+  }
+  return str;
+}
+
+std::string BenchQuotesCorpus(std::size_t size) {
+  std::string str;
+  for (std::size_t i = 0; str.size() < size; ++i) {
+    str += "key" + std::to_string(i % 31) + " ";
+    str += i % 2 ? "'quoted value " : "\"other quoted ";
+    str += std::to_string(i);
+    str += i % 2 ? "' " : "\" ";
+    str += i % 8 ? "" : "\n";
+  }
+  return str;
+}
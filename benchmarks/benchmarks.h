@@ -0,0 +1,40 @@
+#ifndef TOKEN_PARSER_BENCHMARKS_BENCHMARKS_H_
+#define TOKEN_PARSER_BENCHMARKS_BENCHMARKS_H_
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <string>
+
+#include "../include/token_parser/settings.h"
+
+/// @brief Get the path of a scratch file in the temp directory of the
+/// system, so a benchmark run does not write to the current directory.
+std::string BenchTmpFilename(const std::string& name);
+
+/// @brief Words separated by long runs of spaces, tabs and newlines.
+std::string BenchSpacesCorpus(std::size_t size);
+
+/// @brief Long words separated by long runs of spaces.
+std::string BenchLongRunsCorpus(std::size_t size);
+
+/// @brief Words and one quoted multi-line value of the size.
+std::string BenchQuotedBlobCorpus(std::size_t size);
+
+/// @brief Signed ints separated by spaces.
+std::string BenchIntsCorpus(std::size_t size);
+
+/// @brief Decimal and exponent floats separated by spaces.
+std::string BenchFloatsCorpus(std::size_t size);
+
+/// @brief Ids "kw0", "kw1", ... and punctuation ids "(", ")", ";", "=".
+TokenParser::Settings::TokenIds BenchTokenIds(std::size_t count);
+
+/// @brief Code-like text of the BenchTokenIds(ids_count) ids, short words
+/// and ints.
+std::string BenchKeywordsCorpus(std::size_t size, std::size_t ids_count);
+
+/// @brief Words and short quoted strings with spaces.
+std::string BenchQuotesCorpus(std::size_t size);
+
+#endif  // TOKEN_PARSER_BENCHMARKS_BENCHMARKS_H_
@@ -0,0 +1,151 @@
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+
+#include "../include/token_parser/char_set.h"
+#include "../include/token_parser/line_counter.h"
+#include "../include/token_parser/settings.h"
+#include "../include/token_parser/stream_parser.h"
+#include "../include/token_parser/string_parser.h"
+#include "benchmarks.h"
+
+namespace {
+
+const std::size_t kCorpusSize = 1 << 20;
+
+/// @brief Skip spaces by comparing with every space char, as the parser did
+/// before the char classes table.
+std::size_t SkipSpacesScanString(const std::string& str, std::size_t i,
+                                 const std::string& space_chars) {
+  while (i < str.size()) {
+    bool is_space = false;
+    for (char ch : space_chars)
+      if (str[i] == ch) is_space = true;
+    if (!is_space) break;
+    ++i;
+  }
+  return i;
+}
+
+std::size_t SkipSpacesCharClasses(
+    const std::string& str, std::size_t i,
+    const TokenParser::Settings::CharClasses& classes) {
+  while (i < str.size() && (classes[static_cast<unsigned char>(str[i])] &
+                            TokenParser::Settings::kCharClassSpace))
+    ++i;
+  return i;
+}
+
+void BM_SkipSpacesScanString(benchmark::State& state) {
+  std::string str = BenchSpacesCorpus(kCorpusSize);
+  TokenParser::Settings settings;
+  for (auto _ : state) {
+    std::size_t i = 0;
+    while (i < str.size()) {
+      i = SkipSpacesScanString(str, i, settings.GetSpaceChars());
+      while (i < str.size() && str[i] != '\n') ++i;
+    }
+    benchmark::DoNotOptimize(i);
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+void BM_SkipSpacesCharClasses(benchmark::State& state) {
+  std::string str = BenchSpacesCorpus(kCorpusSize);
+  TokenParser::Settings settings;
+  for (auto _ : state) {
+    std::size_t i = 0;
+    while (i < str.size()) {
+      i = SkipSpacesCharClasses(str, i, settings.GetCharClasses());
+      while (i < str.size() && str[i] != '\n') ++i;
+    }
+    benchmark::DoNotOptimize(i);
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+void BM_SkipSpacesCharSet(benchmark::State& state) {
+  std::string str = BenchSpacesCorpus(kCorpusSize);
+  TokenParser::Settings settings;
+  for (auto _ : state) {
+    const char* i = str.data();
+    const char* last = str.data() + str.size();
+    while (i < last) {
+      i = settings.GetSpaceCharSet().FindNot(i, last);
+      i = settings.GetWordDelimCharSet().Find(i, last);
+    }
+    benchmark::DoNotOptimize(i);
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+/// @brief Count the lines by the kernel state.range(0) (CharSet::Kernel).
+void BM_CountNewlines(benchmark::State& state) {
+  std::string str = BenchKeywordsCorpus(kCorpusSize, 8);
+  TokenParser::CharSet::Kernel kernel =
+      static_cast<TokenParser::CharSet::Kernel>(state.range(0));
+  if (!TokenParser::LineCounter::IsKernelSupported(kernel)) {
+    state.SkipWithError("kernel is not supported");
+    return;
+  }
+  for (auto _ : state) {
+    const char* last_newline = nullptr;
+    benchmark::DoNotOptimize(TokenParser::LineCounter::CountNewlines(
+        str.data(), str.data() + str.size(), last_newline, kernel));
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+void BM_StringParserNextWordSpaces(benchmark::State& state) {
+  std::string str = BenchSpacesCorpus(kCorpusSize);
+  TokenParser::StringParser parser(&str);
+  for (auto _ : state) {
+    parser.SetI(0);
+    while (!parser.IsEnd()) benchmark::DoNotOptimize(parser.NextWord());
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+void BM_StringParserNextWordLongRuns(benchmark::State& state) {
+  std::string str = BenchLongRunsCorpus(kCorpusSize);
+  TokenParser::StringParser parser(&str);
+  for (auto _ : state) {
+    parser.SetI(0);
+    while (!parser.IsEnd()) benchmark::DoNotOptimize(parser.NextWord());
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+/// @brief Take every token of indented lines as an id or a word, each
+/// NextId() and NextWord() asks for the start of the lexeme several times.
+void BM_StreamParserIndented(benchmark::State& state) {
+  std::string str;
+  for (std::size_t i = 0; str.size() < kCorpusSize; ++i)
+    str += std::string(4 * (i % 6), ' ') + "kw0 ( name = value ) ;\n";
+
+  TokenParser::Settings settings;
+  settings.SetTokenIds(BenchTokenIds(8));
+  settings.SetWordDelim(settings.GetWordDelimChars() + "();=");
+  for (auto _ : state) {
+    std::istringstream ss(str);
+    TokenParser::StreamParser<char> parser(settings, &ss);
+    while (!parser.IsEnd())
+      if (parser.NextId().IsNull())
+        benchmark::DoNotOptimize(parser.NextWordView());
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_SkipSpacesScanString);
+BENCHMARK(BM_SkipSpacesCharClasses);
+BENCHMARK(BM_SkipSpacesCharSet);
+BENCHMARK(BM_CountNewlines)
+    ->Arg(TokenParser::CharSet::kKernelScalar)
+    ->Arg(TokenParser::CharSet::kKernelSse2)
+    ->Arg(TokenParser::CharSet::kKernelAvx2);
+BENCHMARK(BM_StringParserNextWordSpaces);
+BENCHMARK(BM_StringParserNextWordLongRuns);
+BENCHMARK(BM_StreamParserIndented);
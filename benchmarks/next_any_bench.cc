@@ -0,0 +1,162 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "../include/token_parser/lexeme.h"
+#include "../include/token_parser/settings.h"
+#include "../include/token_parser/string_parser.h"
+#include "benchmarks.h"
+
+namespace {
+
+const std::size_t kCorpusSize = 1 << 20;
+
+TokenParser::Settings MakeSettings() {
+  TokenParser::Settings settings;
+  settings.SetTokenIds(BenchTokenIds(8));
+  settings.SetWordDelim(settings.GetWordDelimChars() + "();=");
+  return settings;
+}
+
+/// @brief Guess the type at the call site, as callers did before NextAny().
+void BM_StringParserTryEach(benchmark::State& state) {
+  std::string str = BenchKeywordsCorpus(kCorpusSize, 8);
+  TokenParser::StringParser parser(MakeSettings());
+  std::size_t tokens = 0;
+  for (auto _ : state) {
+    parser.SetStr(&str);
+    tokens = 0;
+    while (!parser.IsEnd()) {
+      if (parser.NextId().IsNull() && parser.NextInt().IsNull() &&
+          parser.NextFloat().IsNull())
+        benchmark::DoNotOptimize(parser.NextWordView());
+      ++tokens;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+  state.counters["tokens"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * tokens),
+      benchmark::Counter::kIsRate);
+}
+
+void BM_StringParserNextAny(benchmark::State& state) {
+  std::string str = BenchKeywordsCorpus(kCorpusSize, 8);
+  TokenParser::StringParser parser(MakeSettings());
+  std::size_t tokens = 0;
+  for (auto _ : state) {
+    parser.SetStr(&str);
+    tokens = 0;
+    for (auto lexeme = parser.NextAny(); !lexeme.IsEnd();
+         lexeme = parser.NextAny()) {
+      benchmark::DoNotOptimize(lexeme);
+      ++tokens;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+  state.counters["tokens"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * tokens),
+      benchmark::Counter::kIsRate);
+}
+
+void BM_StringParserNextBatch(benchmark::State& state) {
+  std::string str = BenchKeywordsCorpus(kCorpusSize, 8);
+  TokenParser::StringParser parser(MakeSettings());
+  std::vector<TokenParser::Lexeme> lexemes(state.range(0));
+  std::size_t tokens = 0;
+  for (auto _ : state) {
+    parser.SetStr(&str);
+    tokens = 0;
+    while (std::size_t n = parser.NextBatch(lexemes.data(), lexemes.size())) {
+      benchmark::DoNotOptimize(lexemes.data());
+      tokens += n;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+  state.counters["tokens"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * tokens),
+      benchmark::Counter::kIsRate);
+}
+
+/// @brief Parse the statements by a grammar that expects every id, the ids
+/// are multiplied by state.range(0) (1 is dense, a big one is sparse).
+void BM_StringParserNextThisId(benchmark::State& state) {
+  const std::size_t kIdsCount = 1000;
+  std::string str = BenchKeywordsCorpus(kCorpusSize, kIdsCount);
+  TokenParser::Token::id_type scale =
+      static_cast<TokenParser::Token::id_type>(state.range(0));
+  TokenParser::Settings::TokenIds token_ids;
+  for (const auto& token_id : BenchTokenIds(kIdsCount))
+    token_ids.insert({token_id.first * scale, token_id.second});
+  TokenParser::Settings settings = MakeSettings();
+  settings.SetTokenIds(token_ids);
+
+  TokenParser::StringParser parser(settings);
+  std::size_t tokens = 0;
+  for (auto _ : state) {
+    parser.SetStr(&str);
+    tokens = 0;
+    while (!parser.NextId().IsNull()) {
+      benchmark::DoNotOptimize(parser.NextThisId(0 * scale));
+      benchmark::DoNotOptimize(parser.NextWordView());
+      benchmark::DoNotOptimize(parser.NextThisId(3 * scale));
+      benchmark::DoNotOptimize(parser.NextUint());
+      benchmark::DoNotOptimize(parser.NextThisId(1 * scale));
+      benchmark::DoNotOptimize(parser.NextThisId(2 * scale));
+      tokens += 7;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+  state.counters["tokens"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * tokens),
+      benchmark::Counter::kIsRate);
+}
+
+/// @brief Parse the statements by a recursive descent grammar that looks at
+/// the next lexeme before choosing a rule. state.range(0) is 0 to look by
+/// NextAny() and SetI() back, 1 to look by PeekAny().
+void BM_StringParserLookahead(benchmark::State& state) {
+  std::string str = BenchKeywordsCorpus(kCorpusSize, 8);
+  TokenParser::StringParser parser(MakeSettings());
+  bool peek = state.range(0) != 0;
+  auto look = [&parser, peek]() {
+    if (peek) return parser.PeekAny();
+    TokenParser::StringParser::size_type i = parser.GetI();
+    TokenParser::Lexeme lexeme = parser.NextAny();
+    parser.SetI(i);
+    return lexeme;
+  };
+
+  std::size_t tokens = 0;
+  for (auto _ : state) {
+    parser.SetStr(&str);
+    tokens = 0;
+    for (TokenParser::Lexeme lexeme = look(); !lexeme.IsEnd();
+         lexeme = look()) {
+      // The rule of the statement is chosen by its keyword.
+      benchmark::DoNotOptimize(parser.NextId());
+      benchmark::DoNotOptimize(parser.NextThisId(0));
+      if (look().IsWord()) {
+        benchmark::DoNotOptimize(parser.NextWordView());
+        benchmark::DoNotOptimize(parser.NextThisId(3));
+      }
+      if (look().IsToken()) benchmark::DoNotOptimize(parser.NextUint());
+      benchmark::DoNotOptimize(parser.NextThisId(1));
+      benchmark::DoNotOptimize(parser.NextThisId(2));
+      tokens += 7;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+  state.counters["tokens"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * tokens),
+      benchmark::Counter::kIsRate);
+}
+
+}  // namespace
+
+BENCHMARK(BM_StringParserTryEach);
+BENCHMARK(BM_StringParserNextAny);
+BENCHMARK(BM_StringParserNextBatch)->Arg(64)->Arg(4096);
+BENCHMARK(BM_StringParserNextThisId)->Arg(1)->Arg(1 << 16);
+BENCHMARK(BM_StringParserLookahead)->Arg(0)->Arg(1);
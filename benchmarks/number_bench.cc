@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <string>
+
+#include "../include/token_parser/string_parser.h"
+#include "benchmarks.h"
+
+namespace {
+
+const std::size_t kCorpusSize = 1 << 20;
+
+void BM_Strtoll(benchmark::State& state) {
+  std::string str = BenchIntsCorpus(kCorpusSize);
+  for (auto _ : state) {
+    const char* p = str.c_str();
+    char* pend;
+    long long sum = 0;
+    while (*p != '\0') {
+      sum += std::strtoll(p, &pend, 10);
+      p = pend + 1;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+void BM_Strtold(benchmark::State& state) {
+  std::string str = BenchFloatsCorpus(kCorpusSize);
+  for (auto _ : state) {
+    const char* p = str.c_str();
+    char* pend;
+    double sum = 0;
+    while (*p != '\0') {
+      sum += static_cast<double>(std::strtold(p, &pend));
+      p = pend + 1;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+void BM_StringParserNextInt(benchmark::State& state) {
+  std::string str = BenchIntsCorpus(kCorpusSize);
+  TokenParser::StringParser parser(&str);
+  for (auto _ : state) {
+    parser.SetI(0);
+    while (!parser.IsEnd()) benchmark::DoNotOptimize(parser.NextInt());
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+void BM_StringParserNextFloat(benchmark::State& state) {
+  std::string str = BenchFloatsCorpus(kCorpusSize);
+  TokenParser::StringParser parser(&str);
+  for (auto _ : state) {
+    parser.SetI(0);
+    while (!parser.IsEnd()) benchmark::DoNotOptimize(parser.NextFloat());
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_Strtoll);
+BENCHMARK(BM_Strtold);
+BENCHMARK(BM_StringParserNextInt);
+BENCHMARK(BM_StringParserNextFloat);
@@ -0,0 +1,166 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "../include/token_parser/file_parser.h"
+#include "../include/token_parser/parallel_file_parser.h"
+#include "../include/token_parser/read_ahead_streambuf.h"
+#include "../include/token_parser/settings.h"
+#include "../include/token_parser/stream_parser.h"
+#include "../include/token_parser/token_buffer.h"
+#include "benchmarks.h"
+
+namespace {
+
+const std::size_t kCorpusSize = 1 << 24;
+const std::string kTmpFilename =
+    BenchTmpFilename("token_parser_parallel_bench.txt");
+
+TokenParser::Settings MakeSettings() {
+  TokenParser::Settings settings;
+  settings.SetWordDelim(settings.GetWordDelimChars() + "();=");
+  settings.SetTokenIds(BenchTokenIds(64));
+  return settings;
+}
+
+void WriteCorpus() {
+  std::ofstream file(kTmpFilename);
+  file << BenchKeywordsCorpus(kCorpusSize, 64);
+}
+
+void SetCounters(benchmark::State& state, std::size_t tokens) {
+  state.SetBytesProcessed(state.iterations() * kCorpusSize);
+  state.counters["tokens"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * tokens),
+      benchmark::Counter::kIsRate);
+}
+
+void BM_FileParserMmapNextBatch(benchmark::State& state) {
+  WriteCorpus();
+  TokenParser::FileParser parser(MakeSettings());
+  parser.SetBackend(TokenParser::FileParser::kBackendMmap);
+  TokenParser::TokenBuffer buffer;
+  for (auto _ : state) {
+    parser.SetFile(kTmpFilename);
+    buffer.Clear();
+    while (parser.NextBatch(buffer, 4096) != 0) {
+    }
+  }
+  SetCounters(state, buffer.Size());
+  std::remove(kTmpFilename.c_str());
+}
+
+/// @brief Tokenize the file read by the backend state.range(0)
+/// (FileParser::Backend), state.range(1) is 1 to read it past the page cache.
+void BM_FileParserBackend(benchmark::State& state) {
+  WriteCorpus();
+  TokenParser::FileParser parser(MakeSettings());
+  parser.SetBackend(
+      static_cast<TokenParser::FileParser::Backend>(state.range(0)));
+  parser.SetDirectIo(state.range(1) != 0);
+  parser.SetBuffSize(1 << 16);
+  TokenParser::TokenBuffer buffer;
+  for (auto _ : state) {
+    parser.SetFile(kTmpFilename);
+    buffer.Clear();
+    while (parser.NextBatch(buffer, 4096) != 0) {
+    }
+  }
+  SetCounters(state, buffer.Size());
+  std::remove(kTmpFilename.c_str());
+}
+
+/// @brief Tokenize the file by state.range(0) threads, state.range(1) is 1
+/// to track the positions.
+void BM_ParallelFileParser(benchmark::State& state) {
+  WriteCorpus();
+  TokenParser::ParallelFileParser parser(MakeSettings(), kTmpFilename);
+  parser.SetThreads(static_cast<std::size_t>(state.range(0)));
+  parser.SetChunkSize(1 << 20);
+  TokenParser::TokenBuffer buffer;
+  buffer.SetTrackPositions(state.range(1) != 0);
+  for (auto _ : state) {
+    buffer.Clear();
+    parser.Tokenize(buffer);
+  }
+  SetCounters(state, buffer.Size());
+  std::remove(kTmpFilename.c_str());
+}
+
+/// @brief Source that waits before every read, as a network filesystem
+/// does.
+class SlowStringbuf : public std::stringbuf {
+ public:
+  SlowStringbuf(const std::string& str, std::chrono::microseconds latency)
+      : std::stringbuf(str), latency_(latency) {}
+
+ protected:
+  std::streamsize xsgetn(char* s, std::streamsize n) override {
+    std::this_thread::sleep_for(latency_);
+    return std::stringbuf::xsgetn(s, n);
+  }
+
+ private:
+  std::chrono::microseconds latency_;
+};
+
+/// @brief Tokenize a source with 2 ms latency per block, state.range(0) is 1
+/// to read it ahead by a thread.
+void BM_StreamParserSlowSource(benchmark::State& state) {
+  const std::size_t kSize = 1 << 22;
+  const std::size_t kBuffSize = 1 << 16;
+  std::string str = BenchKeywordsCorpus(kSize, 64);
+  TokenParser::StreamParser<char> parser(MakeSettings());
+  parser.SetBuffSize(kBuffSize);
+  TokenParser::ReadAheadStreambuf read_ahead;
+  bool ahead = state.range(0) != 0;
+  TokenParser::TokenBuffer buffer;
+  for (auto _ : state) {
+    SlowStringbuf source(str, std::chrono::microseconds(2000));
+    std::streambuf* buff = &source;
+    if (ahead) {
+      read_ahead.Open(&source, kBuffSize, 4);
+      buff = &read_ahead;
+    }
+    std::istream stream(buff);
+    parser.SetStream(&stream);
+    buffer.Clear();
+    while (parser.NextBatch(buffer, 4096) != 0) {
+    }
+    read_ahead.Close();
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_FileParserMmapNextBatch)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FileParserBackend)
+    ->Args({TokenParser::FileParser::kBackendStream, 0})
+    ->Args({TokenParser::FileParser::kBackendMmap, 0})
+    ->Args({TokenParser::FileParser::kBackendReadAhead, 0})
+    ->Args({TokenParser::FileParser::kBackendAsync, 0})
+    ->Args({TokenParser::FileParser::kBackendAsync, 1})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_ParallelFileParser)
+    ->Args({1, 0})
+    ->Args({2, 0})
+    ->Args({4, 0})
+    ->Args({8, 0})
+    ->Args({1, 1})
+    ->Args({8, 1})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_StreamParserSlowSource)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,247 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../include/token_parser/compiled_settings.h"
+#include "../include/token_parser/file_parser.h"
+#include "../include/token_parser/parser_pool.h"
+#include "../include/token_parser/settings.h"
+#include "../include/token_parser/stream_parser.h"
+#include "../include/token_parser/string_parser.h"
+#include "../include/token_parser/token_buffer.h"
+#include "benchmarks.h"
+
+namespace {
+
+const std::size_t kCorpusSize = 1 << 20;
+const std::string kTmpFilename =
+    BenchTmpFilename("token_parser_bench.txt");
+
+enum Corpus {
+  kCorpusKeywordsFewIds,
+  kCorpusKeywordsManyIds,
+  kCorpusNumbers,
+  kCorpusQuotes,
+  kCorpusLongWords,
+};
+
+struct BenchCase {
+  std::string str_;
+  TokenParser::Settings settings_;
+};
+
+BenchCase MakeBenchCase(Corpus corpus) {
+  BenchCase bench_case;
+  TokenParser::Settings& settings = bench_case.settings_;
+  settings.SetWordDelim(settings.GetWordDelimChars() + "();=");
+
+  switch (corpus) {
+    case kCorpusKeywordsFewIds:
+      settings.SetTokenIds(BenchTokenIds(8));
+      bench_case.str_ = BenchKeywordsCorpus(kCorpusSize, 8);
+      break;
+    case kCorpusKeywordsManyIds:
+      settings.SetTokenIds(BenchTokenIds(1000));
+      bench_case.str_ = BenchKeywordsCorpus(kCorpusSize, 1000);
+      break;
+    case kCorpusNumbers:
+      bench_case.str_ = BenchFloatsCorpus(kCorpusSize / 2);
+      bench_case.str_ += BenchIntsCorpus(kCorpusSize / 2);
+      break;
+    case kCorpusQuotes:
+      settings.SetWordDelim(settings.GetWordDelimChars() + "'\"");
+      settings.SetWordMaySurrondedByQoutes(true);
+      bench_case.str_ = BenchQuotesCorpus(kCorpusSize);
+      break;
+    case kCorpusLongWords:
+      bench_case.str_ = BenchLongRunsCorpus(kCorpusSize);
+      break;
+  }
+  return bench_case;
+}
+
+/// @brief Take every token as an id, a number or a word.
+/// @return Count of tokens.
+template <typename Parser>
+std::size_t ParseAll(Parser& parser) {
+  std::size_t tokens = 0;
+  while (!parser.IsEnd()) {
+    if (parser.NextId().IsNull() && parser.NextFloat().IsNull())
+      benchmark::DoNotOptimize(parser.NextWordView());
+    ++tokens;
+  }
+  return tokens;
+}
+
+void SetCounters(benchmark::State& state, const BenchCase& bench_case,
+                 std::size_t tokens) {
+  state.SetBytesProcessed(state.iterations() * bench_case.str_.size());
+  state.counters["tokens"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * tokens),
+      benchmark::Counter::kIsRate);
+}
+
+void BM_StringParser(benchmark::State& state, Corpus corpus) {
+  BenchCase bench_case = MakeBenchCase(corpus);
+  TokenParser::StringParser parser(bench_case.settings_);
+  std::size_t tokens = 0;
+  for (auto _ : state) {
+    parser.SetStr(&bench_case.str_);
+    tokens = ParseAll(parser);
+  }
+  SetCounters(state, bench_case, tokens);
+}
+
+void BM_StreamParser(benchmark::State& state, Corpus corpus) {
+  BenchCase bench_case = MakeBenchCase(corpus);
+  TokenParser::StreamParser<char> parser(bench_case.settings_);
+  std::size_t tokens = 0;
+  for (auto _ : state) {
+    std::istringstream ss(bench_case.str_);
+    parser.SetStream(&ss);
+    tokens = ParseAll(parser);
+  }
+  SetCounters(state, bench_case, tokens);
+}
+
+void BM_FileParser(benchmark::State& state, Corpus corpus,
+                   TokenParser::FileParser::Backend backend) {
+  BenchCase bench_case = MakeBenchCase(corpus);
+  std::ofstream file(kTmpFilename);
+  file << bench_case.str_;
+  file.close();
+
+  TokenParser::FileParser parser(bench_case.settings_);
+  parser.SetBackend(backend);
+  std::size_t tokens = 0;
+  for (auto _ : state) {
+    parser.SetFile(kTmpFilename);
+    tokens = ParseAll(parser);
+  }
+  SetCounters(state, bench_case, tokens);
+  std::remove(kTmpFilename.c_str());
+}
+
+void BM_FileParserStream(benchmark::State& state, Corpus corpus) {
+  BM_FileParser(state, corpus, TokenParser::FileParser::kBackendStream);
+}
+
+void BM_FileParserMmap(benchmark::State& state, Corpus corpus) {
+  BM_FileParser(state, corpus, TokenParser::FileParser::kBackendMmap);
+}
+
+/// @brief Take every lexeme by NextAny(), state.range(0) is 1 to get the
+/// line and the column of every lexeme.
+void BM_StreamParserPositions(benchmark::State& state) {
+  BenchCase bench_case = MakeBenchCase(kCorpusKeywordsFewIds);
+  TokenParser::StreamParser<char> parser(bench_case.settings_);
+  bool positions = state.range(0) != 0;
+  std::size_t tokens = 0;
+  for (auto _ : state) {
+    std::istringstream ss(bench_case.str_);
+    parser.SetStream(&ss);
+    tokens = 0;
+    for (auto lexeme = parser.NextAny(); !lexeme.IsEnd();
+         lexeme = parser.NextAny()) {
+      if (positions)
+        benchmark::DoNotOptimize(parser.GetPosition(lexeme.GetStart()));
+      ++tokens;
+    }
+  }
+  SetCounters(state, bench_case, tokens);
+}
+
+/// @brief Take the lexemes by NextBatch(), state.range(0) is 1 to keep the
+/// lines and the columns in the buffer.
+void BM_StreamParserBatchPositions(benchmark::State& state) {
+  BenchCase bench_case = MakeBenchCase(kCorpusKeywordsFewIds);
+  TokenParser::StreamParser<char> parser(bench_case.settings_);
+  TokenParser::TokenBuffer buffer;
+  buffer.SetTrackPositions(state.range(0) != 0);
+  for (auto _ : state) {
+    std::istringstream ss(bench_case.str_);
+    parser.SetStream(&ss);
+    buffer.Clear();
+    while (parser.NextBatch(buffer, 4096) != 0) {
+    }
+  }
+  SetCounters(state, bench_case, buffer.Size());
+}
+
+/// @brief Construct a parser per request by copying the settings.
+void BM_StringParserConstructSettings(benchmark::State& state) {
+  TokenParser::Settings settings;
+  settings.SetTokenIds(BenchTokenIds(static_cast<std::size_t>(state.range(0))));
+  std::string str = "kw0 ( name = 1 ) ;";
+  for (auto _ : state) {
+    TokenParser::StringParser parser(settings, &str);
+    benchmark::DoNotOptimize(parser.NextId());
+  }
+}
+
+/// @brief Construct a parser per request by sharing the compiled settings.
+void BM_StringParserConstructCompiled(benchmark::State& state) {
+  TokenParser::Settings settings;
+  settings.SetTokenIds(BenchTokenIds(static_cast<std::size_t>(state.range(0))));
+  TokenParser::CompiledSettings::Ptr compiled =
+      TokenParser::CompiledSettings::Compile(settings);
+  std::string str = "kw0 ( name = 1 ) ;";
+  for (auto _ : state) {
+    TokenParser::StringParser parser(compiled, &str);
+    benchmark::DoNotOptimize(parser.NextId());
+  }
+}
+
+/// @brief Parse short messages by a new parser per message.
+void BM_StreamParserPerMessageNew(benchmark::State& state) {
+  BenchCase bench_case = MakeBenchCase(kCorpusKeywordsFewIds);
+  std::string message = bench_case.str_.substr(0, 256);
+  TokenParser::CompiledSettings::Ptr compiled =
+      TokenParser::CompiledSettings::Compile(bench_case.settings_);
+  for (auto _ : state) {
+    std::istringstream ss(message);
+    TokenParser::StreamParser<char> parser(compiled, &ss);
+    benchmark::DoNotOptimize(ParseAll(parser));
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+/// @brief Parse short messages by parsers reused from a pool.
+void BM_StreamParserPerMessagePool(benchmark::State& state) {
+  BenchCase bench_case = MakeBenchCase(kCorpusKeywordsFewIds);
+  std::string message = bench_case.str_.substr(0, 256);
+  TokenParser::ParserPool<TokenParser::StreamParser<char>> pool(
+      bench_case.settings_);
+  for (auto _ : state) {
+    std::istringstream ss(message);
+    auto parser = pool.Acquire();
+    parser->SetStream(&ss);
+    benchmark::DoNotOptimize(ParseAll(*parser));
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+}  // namespace
+
+#define TOKEN_PARSER_BENCH_CORPORA(func)                              \
+  BENCHMARK_CAPTURE(func, keywords_few_ids, kCorpusKeywordsFewIds);   \
+  BENCHMARK_CAPTURE(func, keywords_many_ids, kCorpusKeywordsManyIds); \
+  BENCHMARK_CAPTURE(func, numbers, kCorpusNumbers);                   \
+  BENCHMARK_CAPTURE(func, quotes, kCorpusQuotes);                     \
+  BENCHMARK_CAPTURE(func, long_words, kCorpusLongWords)
+
+TOKEN_PARSER_BENCH_CORPORA(BM_StringParser);
+TOKEN_PARSER_BENCH_CORPORA(BM_StreamParser);
+TOKEN_PARSER_BENCH_CORPORA(BM_FileParserStream);
+TOKEN_PARSER_BENCH_CORPORA(BM_FileParserMmap);
+
+BENCHMARK(BM_StringParserConstructSettings)->Arg(8)->Arg(1000);
+BENCHMARK(BM_StringParserConstructCompiled)->Arg(8)->Arg(1000);
+BENCHMARK(BM_StreamParserPerMessageNew);
+BENCHMARK(BM_StreamParserPerMessagePool);
+BENCHMARK(BM_StreamParserPositions)->Arg(0)->Arg(1);
+BENCHMARK(BM_StreamParserBatchPositions)->Arg(0)->Arg(1);
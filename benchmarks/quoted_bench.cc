@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+#include "../include/token_parser/settings.h"
+#include "../include/token_parser/stream_parser.h"
+#include "benchmarks.h"
+
+namespace {
+
+void BM_StreamParserQuotedBlob(benchmark::State& state) {
+  std::string str = BenchQuotedBlobCorpus(state.range(0));
+  TokenParser::Settings settings;
+  settings.SetWordDelim(settings.GetWordDelimChars() + "'");
+  settings.SetWordMaySurrondedByQoutes(true);
+  for (auto _ : state) {
+    std::stringstream ss(str);
+    TokenParser::StreamParser<char> parser(settings, &ss);
+    while (!parser.IsEnd()) benchmark::DoNotOptimize(parser.NextWordView());
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+  state.SetComplexityN(state.range(0));
+}
+
+/// @brief Take quoted words as ids, state.range(0) is the count of ids.
+void BM_StreamParserQuotedIds(benchmark::State& state) {
+  std::size_t ids_count = static_cast<std::size_t>(state.range(0));
+  TokenParser::Settings::TokenIds token_ids;
+  for (std::size_t i = 0; i < ids_count; ++i)
+    token_ids.insert({static_cast<int>(i), "'kw " + std::to_string(i) + "'"});
+
+  std::string str;
+  for (std::size_t i = 0; str.size() < (1 << 20); ++i)
+    str += "'kw " + std::to_string(i * 2654435761u % ids_count) + "' ";
+
+  TokenParser::Settings settings;
+  settings.SetTokenIds(token_ids);
+  settings.SetWordDelim(settings.GetWordDelimChars() + "'");
+  settings.SetWordMaySurrondedByQoutes(true);
+  for (auto _ : state) {
+    std::stringstream ss(str);
+    TokenParser::StreamParser<char> parser(settings, &ss);
+    while (!parser.IsEnd()) benchmark::DoNotOptimize(parser.NextId());
+  }
+  state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_StreamParserQuotedBlob)
+    ->RangeMultiplier(4)
+    ->Range(1 << 18, 1 << 24)
+    ->Complexity(benchmark::oN);
+BENCHMARK(BM_StreamParserQuotedIds)->Arg(8)->Arg(1000);
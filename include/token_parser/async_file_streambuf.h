@@ -0,0 +1,147 @@
+#ifndef TOKEN_PARSER_ASYNC_FILE_STREAMBUF_H_
+#define TOKEN_PARSER_ASYNC_FILE_STREAMBUF_H_
+
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace TokenParser {
+
+/// @brief Input stream buffer of a regular file that keeps several reads of
+/// blocks queued ahead by io_uring, without a thread. The reader takes
+/// chars of the first block while the kernel reads the next ones. Where
+/// io_uring is unavailable (not Linux, old kernels, seccomp) the blocks are
+/// read one by one by pread().
+class AsyncFileStreambuf : public std::streambuf {
+ public:
+  using size_type = std::string::size_type;
+
+  /// @brief The way the blocks are read.
+  enum Engine {
+    /// @brief Queue the reads of count blocks by io_uring.
+    kEngineUring,
+    /// @brief Read the block by pread() when the reader needs it.
+    kEnginePread,
+  };
+
+  AsyncFileStreambuf();
+  AsyncFileStreambuf(const AsyncFileStreambuf& other) = delete;
+  AsyncFileStreambuf(AsyncFileStreambuf&& other) = delete;
+  AsyncFileStreambuf& operator=(const AsyncFileStreambuf& other) = delete;
+  AsyncFileStreambuf& operator=(AsyncFileStreambuf&& other) = delete;
+  virtual ~AsyncFileStreambuf();
+
+  /// @brief Open the file and queue the reads of the first blocks, the
+  /// previous file is closed. The memory of the blocks and the ring are
+  /// reused.
+  /// @param buff_size count of chars of a block, rounded up to the
+  /// alignment of direct reads if direct_io.
+  /// @param count count of blocks, at least 2 to read while the reader
+  /// takes chars.
+  /// @param direct_io read by O_DIRECT past the page cache, for files that
+  /// are scanned once. The file is read through the page cache if its file
+  /// system does not take direct reads.
+  /// @param engine kEnginePread to read without io_uring.
+  /// @return false if the file can not be opened or is not a regular file.
+  bool Open(const std::string& filename, size_type buff_size,
+            size_type count, bool direct_io = false,
+            Engine engine = kEngineUring);
+
+  /// @brief Open the file by its descriptor as Open() does, the descriptor
+  /// is closed by Close(). The reads are direct if it is opened by O_DIRECT.
+  /// @return false if fd is not a regular file, the descriptor is closed.
+  bool Open(int fd, size_type buff_size, size_type count,
+            Engine engine = kEngineUring);
+
+  /// @brief Wait for the queued reads and close the file.
+  void Close();
+
+  bool IsOpen() const;
+
+  /// @brief Get the engine the open file is read by.
+  Engine GetEngine() const;
+
+  /// @brief Check if the file is read by O_DIRECT.
+  bool IsDirectIo() const;
+
+  /// @brief Get errno of the failed read or 0. A failed read throws
+  /// std::ios_base::failure from underflow(), so the istream gets badbit.
+  int GetError() const;
+
+  /// @brief Check if io_uring can be set up by this process.
+  static bool IsUringSupported();
+
+ protected:
+  int_type underflow() override;
+
+ private:
+  struct Block {
+    std::vector<char> chars_;
+    /// @brief Aligned start of chars_.
+    char* data_;
+    /// @brief Offset of the block in the file.
+    size_type offset_;
+    /// @brief Count of chars read.
+    size_type size_;
+    /// @brief Count of chars the block should get, less than the block
+    /// size only for the last block of the file.
+    size_type expected_;
+    /// @brief The read of the block is queued.
+    bool pending_;
+    /// @brief errno of the failed read or 0.
+    int error_;
+  };
+
+  struct Ring;
+
+  static const size_type kMinCount_;
+  static const size_type kDirectAlignment_;
+
+  /// @brief Start the read of the block at next_offset_ in the block slot.
+  /// @return false if the reads of all blocks of the file are started.
+  bool StartBlock(size_type slot);
+
+  /// @brief Queue the read of the rest of the block slot.
+  void QueueRead(size_type slot);
+
+  /// @brief Wait until the block slot is read, the short reads are queued
+  /// again.
+  /// @return false on a read error.
+  bool WaitBlock(size_type slot);
+
+  /// @brief Submit the queued reads and take the completions, waits for at
+  /// least one.
+  /// @return false if the ring fails.
+  bool Reap();
+
+  /// @brief Read the rest of the block slot by pread().
+  /// @return false on a read error.
+  bool ReadBlock(size_type slot);
+
+  /// @brief Read the file through the page cache after the file system
+  /// refused a direct read.
+  bool DropDirectIo();
+
+  int fd_;
+  std::unique_ptr<Ring> ring_;
+  std::vector<Block> blocks_;
+  Engine engine_;
+  bool direct_io_;
+  size_type block_size_;
+  /// @brief Size of the file at Open(), the file must not be truncated
+  /// while it is read.
+  size_type file_size_;
+  /// @brief Offset of the next block to start.
+  size_type next_offset_;
+  /// @brief Block taken by the reader or the next one to take.
+  size_type head_;
+  /// @brief The reader takes chars of blocks_[head_].
+  bool reading_;
+  /// @brief errno of the failed read or 0, kept after Close().
+  int error_;
+};
+
+}  // namespace TokenParser
+
+#endif  // TOKEN_PARSER_ASYNC_FILE_STREAMBUF_H_
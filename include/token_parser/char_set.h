@@ -0,0 +1,78 @@
+#ifndef TOKEN_PARSER_CHAR_SET_H_
+#define TOKEN_PARSER_CHAR_SET_H_
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+namespace TokenParser {
+
+/// @brief Set of chars with vectorized search. The SSE2 and AVX2 kernels
+/// compare 16 or 32 chars at a time with every char of the set, so they are
+/// used for sets of up to kMaxVectorChars chars, bigger sets are searched by
+/// the scalar kernel. The kernel is chosen at runtime by the cpu features.
+class CharSet {
+ public:
+  enum Kernel {
+    kKernelScalar,
+    kKernelSse2,
+    kKernelAvx2,
+  };
+
+  static constexpr std::string::size_type kMaxVectorChars = 16;
+
+  /// @brief Count of chars that Find() and FindNot() check one by one before
+  /// the vector kernel, most runs of spaces and words are short.
+  static constexpr std::ptrdiff_t kScalarPrefix = 16;
+
+  CharSet();
+  CharSet(const std::string& chars);
+  CharSet(const CharSet& other) = default;
+  CharSet(CharSet&& other) noexcept = default;
+  CharSet& operator=(const CharSet& other) = default;
+  CharSet& operator=(CharSet&& other) noexcept = default;
+  virtual ~CharSet();
+
+  /// @brief Set the chars of the set.
+  void Assign(const std::string& chars);
+
+  bool Contains(char ch) const;
+
+  /// @brief Get the kernel that Find() and FindNot() use.
+  Kernel GetKernel() const;
+
+  /// @brief Find the first char in [first, last) that is in the set.
+  /// @return Pointer to the char or last if there is no such char.
+  const char* Find(const char* first, const char* last) const;
+
+  /// @brief Find the first char in [first, last) that is not in the set.
+  /// @return Pointer to the char or last if there is no such char.
+  const char* FindNot(const char* first, const char* last) const;
+
+  /// @brief Find() by the kernel.
+  /// @warning Undefined behavior if !IsKernelSupported(kernel).
+  const char* Find(const char* first, const char* last, Kernel kernel) const;
+
+  /// @brief FindNot() by the kernel.
+  /// @warning Undefined behavior if !IsKernelSupported(kernel).
+  const char* FindNot(const char* first, const char* last,
+                      Kernel kernel) const;
+
+  /// @brief Check if the kernel may be used on this cpu.
+  static bool IsKernelSupported(Kernel kernel);
+
+ private:
+  /// @brief Scan [first, last) by the kernel until the char is in_set.
+  const char* FindByKernel(const char* first, const char* last, bool in_set,
+                           Kernel kernel) const;
+
+  std::array<bool, 256> table_;
+  std::string chars_;
+  Kernel kernel_;
+};
+
+}  // namespace TokenParser
+
+#include "../../src/char_set.inc"
+
+#endif  // TOKEN_PARSER_CHAR_SET_H_
@@ -0,0 +1,53 @@
+#ifndef TOKEN_PARSER_COMPILED_SETTINGS_H_
+#define TOKEN_PARSER_COMPILED_SETTINGS_H_
+
+#include <memory>
+
+#include "settings.h"
+
+namespace TokenParser {
+
+/// @brief Settings with every lookup table (keyword trie, char classes, char
+/// sets) built, that are not changed after the construction. Parsers share
+/// one CompiledSettings by Ptr, so constructing a parser from a Ptr copies a
+/// pointer and the settings may be read by parsers on several threads.
+class CompiledSettings {
+ public:
+  using Ptr = std::shared_ptr<const CompiledSettings>;
+
+  CompiledSettings();
+  CompiledSettings(const Settings& settings);
+  CompiledSettings(Settings&& settings);
+  CompiledSettings(const CompiledSettings& other) = default;
+  CompiledSettings(CompiledSettings&& other) noexcept = default;
+  CompiledSettings& operator=(const CompiledSettings& other) = default;
+  CompiledSettings& operator=(CompiledSettings&& other) noexcept = default;
+  virtual ~CompiledSettings();
+
+  /// @brief Compile the settings to a shared CompiledSettings.
+  static Ptr Compile(const Settings& settings);
+
+  /// @brief Compile the settings to a shared CompiledSettings.
+  static Ptr Compile(Settings&& settings);
+
+  /// @brief Get the shared CompiledSettings of the default Settings.
+  static const Ptr& GetDefault();
+
+  const Settings& GetSettings() const;
+
+  /// @brief Check if the ids that start with a word char have no word delim
+  /// chars, so a full word id is found by the whole word in
+  /// Settings::GetKeywordHash().
+  bool GetIdIsWord() const;
+
+ private:
+  /// @brief Build the lookup tables that Settings builds lazily.
+  void Build();
+
+  Settings settings_;
+  bool id_is_word_;
+};
+
+}  // namespace TokenParser
+
+#endif  // TOKEN_PARSER_COMPILED_SETTINGS_H_
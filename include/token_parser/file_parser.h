@@ -44,6 +44,19 @@ USAGE:
   TokenParser::FileParser file_parser(settings);
   file_parser.SetFile("filename");
 
+  TokenParser::FileParser mmap_parser(settings);
+  mmap_parser.SetBackend(TokenParser::FileParser::kBackendMmap);
+  mmap_parser.SetFile("filename");
+
+  TokenParser::FileParser read_ahead_parser(settings);
+  read_ahead_parser.SetBackend(TokenParser::FileParser::kBackendReadAhead);
+  read_ahead_parser.SetFile("filename");
+
+  TokenParser::FileParser uring_parser(settings);
+  uring_parser.SetBackend(TokenParser::FileParser::kBackendAsync);
+  uring_parser.SetDirectIo(true);
+  uring_parser.SetFile("filename");
+
 3. Use by Next* methods. Check if end by IsEnd() method.
 
   std::string str = "int32_t main() { int a=3.3; }";
@@ -71,11 +84,22 @@ USAGE:
 #define TOKEN_PARSER_FILE_PARSER_H_
 
 #include <fstream>
+#include <istream>
+#include <memory>
 #include <string>
-
+#include <string_view>
+#include <vector>
+
+#include "async_file_streambuf.h"
+#include "compiled_settings.h"
+#include "lexeme.h"
+#include "position.h"
+#include "read_ahead_streambuf.h"
+#include "mapped_file.h"
 #include "settings.h"
 #include "stream_parser.h"
 #include "token.h"
+#include "token_buffer.h"
 
 namespace TokenParser {
 
@@ -87,35 +111,115 @@ class FileParser {
   using stream_parser_type = StreamParser<char_type>;
   using size_type = stream_parser_type::size_type;
 
+  /// @brief The way the file is read.
+  enum Backend {
+    /// @brief Read by std::ifstream into the buffered-string.
+    kBackendStream,
+    /// @brief Map the whole file to memory and parse it without copying.
+    /// Files that can not be mapped (pipes, devices) are read as streams.
+    kBackendMmap,
+    /// @brief Read the file by a thread into blocks of GetBuffSize() chars
+    /// while the current block is parsed, see SetReadAheadCount().
+    kBackendReadAhead,
+    /// @brief Keep the reads of GetReadAheadCount() blocks queued by
+    /// io_uring without a thread, or read them by pread() where io_uring is
+    /// unavailable, see AsyncFileStreambuf. Files that are not regular are
+    /// read as streams.
+    kBackendAsync,
+  };
+
   FileParser();
   FileParser(const Settings& settings);
   FileParser(Settings&& settings);
   FileParser(const std::string& filename);
   FileParser(const Settings& settings, const std::string& filename);
   FileParser(Settings&& settings, const std::string& filename);
+  FileParser(CompiledSettings::Ptr settings);
+  FileParser(CompiledSettings::Ptr settings, const std::string& filename);
   FileParser(const FileParser& other) = delete;
   FileParser(FileParser&& other) noexcept = default;
   FileParser& operator=(const FileParser& other) = delete;
   FileParser& operator=(FileParser&& other) noexcept = default;
   virtual ~FileParser();
 
-  /// @brief Set the file that will be parsed.
+  /// @brief Set the file that will be parsed. The buffers of the previous
+  /// file are reused.
   void SetFile(const std::string& filename);
 
+  /// @brief Close the file to reuse the parser for the next input. The
+  /// settings and the memory of the buffers are kept.
+  void Reset();
+
+  /// @brief Free the memory of the buffer that is not used now.
+  void ShrinkToFit();
+
+  /// @brief Set the way the next SetFile() reads the file.
+  /// @param backend default is kBackendStream.
+  void SetBackend(Backend backend);
+
+  /// @brief Set the count of chars that are read from the file at once by
+  /// the stream backend.
+  /// @param buff_size default is 65536.
+  void SetBuffSize(size_type buff_size);
+
+  /// @brief Set the count of blocks the read-ahead and the async backends
+  /// read ahead, including the parsed one. It is used by the next SetFile().
+  /// @param count default is 4, at least 2.
+  void SetReadAheadCount(size_type count);
+
+  /// @brief Read past the page cache by the async backend, for files that
+  /// are scanned once. It is used by the next SetFile().
+  /// @param direct_io default is false.
+  void SetDirectIo(bool direct_io);
+
   /// @brief Set settings.
   void SetSettings(const Settings& settings);
 
   /// @brief set settings.
   void SetSettings(Settings&& settings);
 
+  /// @brief Set settings shared with other parsers, copies the pointer.
+  void SetSettings(CompiledSettings::Ptr settings);
+
   /// @brief Get current buffered-string from file.
+  /// @warning Empty if the file is mapped, use GetView().
   const std::string* GetStr() const;
 
+  /// @brief Get current buffered chars (the whole file if it is mapped),
+  /// GetI() is the index in them.
+  std::string_view GetView() const;
+
   /// @brief Get index current buffered-string from file.
   size_type GetI() const;
 
+  Backend GetBackend() const;
+  size_type GetBuffSize() const;
+  size_type GetReadAheadCount() const;
+  bool GetDirectIo() const;
+
+  /// @brief Get the offset of the buffered chars (GetView()) in the file.
+  size_type GetViewOffset() const;
+
+  /// @brief Check if the current file is mapped to memory.
+  bool IsMapped() const;
+
+  /// @brief Check if a read of the file failed, so IsEnd() is true before
+  /// the end of the file.
+  bool HasReadError() const;
+
+  /// @brief Get the settings, see StringParser::GetSettings().
   const Settings& GetSettings() const;
-  Settings& GetSettings();
+
+  /// @brief Get the settings to share them with other parsers.
+  const CompiledSettings::Ptr& GetCompiledSettings() const;
+
+  /// @brief Get the position of the char at i (GetI()), the offset is the
+  /// offset in the file.
+  Position GetPosition() const;
+
+  /// @brief Get the position of the buffered char at index i, e.g. of
+  /// Lexeme::GetStart(), see StringParser::GetPosition().
+  Position GetPosition(size_type i) const;
 
   /// @brief Check if file is end or contain only space chars
   /// (settings.GetSpaceChars()).
@@ -126,6 +230,12 @@ class FileParser {
   /// @return Next word or empty string if no word next.
   std::string NextWord();
 
+  /// @brief Get the next word as NextWord() does, but without copying it.
+  /// @warning The view points into the buffered-string (GetStr()), it is
+  /// valid until the next call of a Next* method.
+  /// @return Next word or empty view if no word next.
+  std::string_view NextWordView();
+
   /// @brief Get next int-token.
   /// @return Next int-token or null-token if no int next.
   Token NextInt();
@@ -147,9 +257,92 @@ class FileParser {
   /// @return Next this id-token or null-token if no this id next.
   Token NextThisId(Token::id_type id);
 
+  /// @brief Get the next lexeme as StringParser::NextAny() does.
+  /// @warning The text of the lexeme points into the buffered chars
+  /// (GetView()), it is valid until the next call of a Next* method.
+  /// @return Next lexeme or end-lexeme if the file is end.
+  Lexeme NextAny();
+
+  /// @brief Get the next lexemes as StringParser::NextAny() does.
+  /// @warning The texts of the lexemes point into the buffered chars
+  /// (GetView()), they are valid until the next call of a Next* method.
+  /// @return Count of lexemes written to lexemes, 0 only if the file is end.
+  size_type NextBatch(Lexeme* lexemes, size_type count);
+
+  /// @brief Append the next lexemes to the buffer as NextAny() does, the
+  /// offsets are offsets in the file. The lines and the columns are kept if
+  /// buffer.IsTrackingPositions().
+  /// @return Count of lexemes appended, less than count only if the file is
+  /// end.
+  size_type NextBatch(TokenBuffer& buffer, size_type count);
+
+  /// @brief Get the next id-token as NextId() does, without moving i. The
+  /// result is kept for NextId() at the same i.
+  /// @return Next id-token or null-token if no id next.
+  Token PeekId();
+
+  /// @brief Get the next word as NextWord() does, without moving i. The
+  /// result is kept for NextWord() at the same i.
+  /// @return Next word or empty string if no word next.
+  std::string PeekWord();
+
+  /// @brief PeekWord() without copying the word.
+  /// @warning The view points into the buffered chars (GetView()), it is
+  /// valid until the next call of a Next* method.
+  std::string_view PeekWordView();
+
+  /// @brief Get the next lexeme as NextAny() does, without moving i. The
+  /// result is kept for NextAny(), NextId() and NextWord() at the same i.
+  /// @warning The text of the lexeme points into the buffered chars
+  /// (GetView()), it is valid until the next call of a Next* method.
+  /// @return Next lexeme or end-lexeme if the file is end.
+  Lexeme PeekAny();
+
  private:
+  /// @brief The file and the stream of the read-ahead backend. They are
+  /// allocated once, so the thread does not see them moved with the parser.
+  struct ReadAhead {
+    ReadAhead();
+
+    std::filebuf file_;
+    ReadAheadStreambuf buff_;
+    std::istream stream_;
+  };
+
+  /// @brief The stream of the async backend, allocated once as ReadAhead.
+  struct Async {
+    Async();
+
+    AsyncFileStreambuf buff_;
+    std::istream stream_;
+  };
+
+  static const Backend kDefaultBackend_;
+  static const size_type kFileBuffSize_;
+  static const size_type kDefaultReadAheadCount_;
+
+  /// @brief Open the file for the read-ahead backend.
+  void OpenReadAhead(const std::string& filename);
+
+  /// @brief Stop the thread of the read-ahead backend and close the file.
+  void CloseReadAhead();
+
+  /// @brief Open the file for the async backend.
+  /// @return false if the file is not a regular file.
+  bool OpenAsync(const std::string& filename);
+
+  /// @brief Close the file of the async backend and clear its read error.
+  void CloseAsync();
+
   stream_parser_type stream_parser_;
+  std::vector<char> file_buff_;
   std::ifstream file_;
+  MappedFile mapped_file_;
+  Backend backend_;
+  std::unique_ptr<ReadAhead> read_ahead_;
+  size_type read_ahead_count_;
+  std::unique_ptr<Async> async_;
+  bool direct_io_;
 };
 
 }  // namespace TokenParser
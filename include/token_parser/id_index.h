@@ -0,0 +1,66 @@
+#ifndef TOKEN_PARSER_ID_INDEX_H_
+#define TOKEN_PARSER_ID_INDEX_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "token.h"
+
+namespace TokenParser {
+
+/// @brief Index from token id to its text. The texts are kept in one
+/// contiguous arena. Small non-negative ids are looked up in a dense table
+/// indexed by id, other ids by binary search in a table sorted by id.
+class IdIndex {
+ public:
+  using id_type = Token::id_type;
+  using size_type = std::string::size_type;
+  using TokenIds = std::map<id_type, std::string>;
+
+  /// @brief Ids are dense if they are non-negative and the table indexed by
+  /// id has at most kDenseFactor slots per id (plus kDenseSlack slots).
+  static constexpr size_type kDenseFactor = 4;
+  static constexpr size_type kDenseSlack = 64;
+
+  IdIndex();
+  IdIndex(const TokenIds& token_ids);
+  IdIndex(const IdIndex& other) = default;
+  IdIndex(IdIndex&& other) noexcept = default;
+  IdIndex& operator=(const IdIndex& other) = default;
+  IdIndex& operator=(IdIndex&& other) noexcept = default;
+  virtual ~IdIndex();
+
+  /// @brief Rebuild the index from token ids.
+  void Build(const TokenIds& token_ids);
+
+  bool Empty() const;
+
+  /// @brief Check if the ids are looked up in the dense table.
+  bool IsDense() const;
+
+  /// @brief Find the text of the id.
+  /// @return false if there is no such id.
+  /// @warning The text is valid until the next Build().
+  bool Find(id_type id, std::string_view& text) const;
+
+ private:
+  struct Entry {
+    id_type id_;
+    uint32_t offset_;
+    uint32_t length_;
+    bool used_;
+  };
+
+  std::vector<Entry> entries_;
+  std::string texts_;
+  bool dense_;
+};
+
+}  // namespace TokenParser
+
+#include "../../src/id_index.inc"
+
+#endif  // TOKEN_PARSER_ID_INDEX_H_
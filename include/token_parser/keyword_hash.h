@@ -0,0 +1,63 @@
+#ifndef TOKEN_PARSER_KEYWORD_HASH_H_
+#define TOKEN_PARSER_KEYWORD_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "token.h"
+
+namespace TokenParser {
+
+/// @brief Hash table compiled from token ids. Finds the id whose text is
+/// equal to a whole word in one hash and a few compares, the cost does not
+/// depend on the count of ids. Open addressing with linear probing, the
+/// table is at most half full.
+class KeywordHash {
+ public:
+  using id_type = Token::id_type;
+  using size_type = std::string::size_type;
+  using TokenIds = std::map<id_type, std::string>;
+
+  KeywordHash();
+  KeywordHash(const TokenIds& token_ids);
+  KeywordHash(const KeywordHash& other) = default;
+  KeywordHash(KeywordHash&& other) noexcept = default;
+  KeywordHash& operator=(const KeywordHash& other) = default;
+  KeywordHash& operator=(KeywordHash&& other) noexcept = default;
+  virtual ~KeywordHash();
+
+  /// @brief Rebuild the table from token ids. If several ids have the same
+  /// text, the smallest id is kept.
+  void Build(const TokenIds& token_ids);
+
+  bool Empty() const;
+
+  /// @brief Find the id whose text is equal to the word.
+  /// @return false if there is no such id.
+  bool Find(std::string_view word, id_type& id) const;
+
+ private:
+  struct Slot {
+    std::size_t hash_;
+    uint32_t offset_;
+    uint32_t length_;
+    id_type id_;
+    bool used_;
+  };
+
+  static std::size_t Hash(std::string_view word);
+
+  std::vector<Slot> slots_;
+  std::string texts_;
+  std::size_t mask_;
+};
+
+}  // namespace TokenParser
+
+#include "../../src/keyword_hash.inc"
+
+#endif  // TOKEN_PARSER_KEYWORD_HASH_H_
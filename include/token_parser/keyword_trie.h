@@ -0,0 +1,71 @@
+#ifndef TOKEN_PARSER_KEYWORD_TRIE_H_
+#define TOKEN_PARSER_KEYWORD_TRIE_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "token.h"
+
+namespace TokenParser {
+
+/// @brief Prefix tree compiled from token ids. Finds every id whose text is a
+/// prefix of a string in one forward scan, so the cost depends on the length
+/// of the ids, not on their count.
+class KeywordTrie {
+ public:
+  using id_type = Token::id_type;
+  using size_type = std::string::size_type;
+  using TokenIds = std::map<id_type, std::string>;
+
+  KeywordTrie();
+  KeywordTrie(const TokenIds& token_ids);
+  KeywordTrie(const KeywordTrie& other) = default;
+  KeywordTrie(KeywordTrie&& other) noexcept = default;
+  KeywordTrie& operator=(const KeywordTrie& other) = default;
+  KeywordTrie& operator=(KeywordTrie&& other) noexcept = default;
+  virtual ~KeywordTrie();
+
+  /// @brief Rebuild the trie from token ids. If several ids have the same
+  /// text, the smallest id is kept.
+  void Build(const TokenIds& token_ids);
+
+  bool Empty() const;
+
+  /// @brief Call f(len, id) for every id whose text is a prefix of
+  /// [first, last), in order of increasing len.
+  template <typename F>
+  void ForEachPrefix(const char* first, const char* last, F f) const;
+
+  /// @brief Check if [first, last) is a prefix of the text of an id and is
+  /// shorter than it.
+  bool IsProperPrefix(const char* first, const char* last) const;
+
+  /// @brief Get the length of the longest text of the ids.
+  size_type GetMaxLength() const;
+
+ private:
+  struct Node {
+    uint32_t edges_begin_;
+    uint32_t edges_end_;
+    id_type id_;
+    bool has_id_;
+  };
+
+  static constexpr uint32_t kNoNode_ = UINT32_MAX;
+
+  /// @brief Get the child of node by ch or kNoNode_.
+  uint32_t Child(uint32_t node, char ch) const;
+
+  std::vector<Node> nodes_;
+  std::vector<unsigned char> edge_chars_;
+  std::vector<uint32_t> edge_nodes_;
+  size_type max_length_;
+};
+
+}  // namespace TokenParser
+
+#include "../../src/keyword_trie.inc"
+
+#endif  // TOKEN_PARSER_KEYWORD_TRIE_H_
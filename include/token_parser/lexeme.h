@@ -0,0 +1,63 @@
+#ifndef TOKEN_PARSER_LEXEME_H_
+#define TOKEN_PARSER_LEXEME_H_
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "token.h"
+
+namespace TokenParser {
+
+/// @brief Classified lexeme: a token (id, int, uint, float) or a word, with
+/// its chars. A lexeme that is neither a token nor a word is the end.
+class Lexeme {
+ public:
+  using size_type = std::string::size_type;
+
+  /// @brief Construct end-lexeme.
+  Lexeme();
+
+  /// @brief Construct token-lexeme.
+  Lexeme(const Token& token, std::string_view text, size_type start);
+
+  /// @brief Construct word-lexeme.
+  Lexeme(std::string_view word, size_type start);
+
+  Lexeme(const Lexeme& other) = default;
+  Lexeme(Lexeme&& other) noexcept = default;
+  Lexeme& operator=(const Lexeme& other) = default;
+  Lexeme& operator=(Lexeme&& other) noexcept = default;
+  ~Lexeme() = default;
+
+  bool operator==(const Lexeme& other) const;
+  bool operator!=(const Lexeme& other) const;
+
+  /// @brief Get the token, null-token if the lexeme is a word or the end.
+  const Token& GetToken() const;
+
+  /// @brief Get the chars of the lexeme.
+  /// @warning The view points into the parsing chars, see the parser method
+  /// that returned the lexeme for how long it is valid.
+  std::string_view GetText() const;
+
+  /// @brief Get the index of the first char of the lexeme in the parsing
+  /// chars (GetView() of the parser).
+  size_type GetStart() const;
+
+  bool IsToken() const;
+  bool IsWord() const;
+  bool IsEnd() const;
+
+ private:
+  Token token_;
+  std::string_view text_;
+  size_type start_;
+};
+
+static_assert(std::is_trivially_copyable_v<Lexeme>,
+              "Lexeme must be trivially copyable");
+
+}  // namespace TokenParser
+
+#endif  // TOKEN_PARSER_LEXEME_H_
@@ -0,0 +1,80 @@
+#ifndef TOKEN_PARSER_LINE_COUNTER_H_
+#define TOKEN_PARSER_LINE_COUNTER_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "char_set.h"
+#include "position.h"
+
+namespace TokenParser {
+
+/// @brief Positions of the chars of a string by counting newlines. The
+/// newlines are counted from the last asked index, so asking the positions
+/// in increasing order counts every char once. The SSE2 and AVX2 kernels
+/// count 16 or 32 chars at a time. The newlines of the next 64 chars are
+/// kept as a bit mask, so the short steps between the lexemes are counted
+/// by a few bit operations.
+class LineCounter {
+ public:
+  using size_type = std::string::size_type;
+
+  LineCounter();
+  LineCounter(const LineCounter& other) = default;
+  LineCounter(LineCounter&& other) noexcept = default;
+  LineCounter& operator=(const LineCounter& other) = default;
+  LineCounter& operator=(LineCounter&& other) noexcept = default;
+  virtual ~LineCounter();
+
+  /// @brief Count the chars of a new string.
+  /// @param base position of the first char of the string.
+  void Reset(const Position& base = Position());
+
+  /// @brief Get the position of the first char of the string.
+  const Position& GetBase() const;
+
+  /// @brief Get the position of str[i], i may be str.length().
+  /// @param str the string, the same chars for all the calls since
+  /// Reset(). Chars after the asked indexes may be appended.
+  Position PositionAt(std::string_view str, size_type i);
+
+  /// @brief PositionAt() for count chars in one pass, the lines and the
+  /// columns are written to the arrays.
+  /// @param offsets offsets of the chars in the source, that is
+  /// GetBase().GetOffset() plus the indexes in str.
+  void PositionsAt(std::string_view str, const size_type* offsets,
+                   size_type count, size_type* lines, size_type* columns);
+
+  /// @brief Count '\n' chars in [first, last).
+  /// @param last_newline set to the last '\n' char, not changed if there is
+  /// no one.
+  static size_type CountNewlines(const char* first, const char* last,
+                                 const char*& last_newline);
+
+  /// @brief Check if the CPU runs the kernel of CountNewlines(), the AVX2
+  /// kernel also needs POPCNT.
+  static bool IsKernelSupported(CharSet::Kernel kernel);
+
+  /// @brief CountNewlines() by the kernel.
+  /// @warning Undefined behavior if !IsKernelSupported(kernel).
+  static size_type CountNewlines(const char* first, const char* last,
+                                 const char*& last_newline,
+                                 CharSet::Kernel kernel);
+
+ private:
+  Position base_;
+  /// @brief Index up to which the newlines are counted.
+  size_type i_;
+  /// @brief Line of str[i_].
+  size_type line_;
+  /// @brief Offset of the first char of the line of str[i_].
+  size_type line_offset_;
+  /// @brief Bit k is set if str[i_ + k] is '\n', for i_ + k < mask_end_.
+  uint64_t mask_;
+  size_type mask_end_;
+};
+
+}  // namespace TokenParser
+
+#endif  // TOKEN_PARSER_LINE_COUNTER_H_
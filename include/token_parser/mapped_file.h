@@ -0,0 +1,44 @@
+#ifndef TOKEN_PARSER_MAPPED_FILE_H_
+#define TOKEN_PARSER_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace TokenParser {
+
+/// @brief Read-only memory mapping of a regular file. The mapping is advised
+/// for sequential access and is unmapped by Close() or the destructor.
+class MappedFile {
+ public:
+  MappedFile();
+  MappedFile(const std::string& filename);
+  MappedFile(const MappedFile& other) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(const MappedFile& other) = delete;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  virtual ~MappedFile();
+
+  /// @brief Map the file, the previous mapping is closed.
+  /// @return false if the file can not be opened, is not a regular file or
+  /// can not be mapped (e.g. pipes, devices, not POSIX systems).
+  bool Open(const std::string& filename);
+
+  /// @brief Unmap the file.
+  void Close();
+
+  bool IsOpen() const;
+
+  /// @brief Get the chars of the file.
+  /// @return Chars of the file or empty view if not open.
+  std::string_view GetView() const;
+
+ private:
+  void* data_;
+  std::size_t size_;
+  bool is_open_;
+};
+
+}  // namespace TokenParser
+
+#endif  // TOKEN_PARSER_MAPPED_FILE_H_
@@ -0,0 +1,131 @@
+#ifndef TOKEN_PARSER_PARALLEL_FILE_PARSER_H_
+#define TOKEN_PARSER_PARALLEL_FILE_PARSER_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "lexeme.h"
+#include "mapped_file.h"
+#include "position.h"
+#include "settings.h"
+#include "string_parser.h"
+#include "token_buffer.h"
+
+namespace TokenParser {
+
+/// @brief Parallel file parser. Maps the file to memory, cuts it into chunks
+/// after boundary chars (see Settings::GetBoundaryChars()) and classifies
+/// the lexemes of the chunks (as StringParser::NextAny()) on several
+/// threads, each one with its own StringParser over the shared
+/// CompiledSettings.
+/// @brief The result is the same as of one StringParser over the whole file:
+/// a lexeme that crosses the end of its chunk (e.g. a quoted word with
+/// spaces) makes the next chunk be parsed again from the end of the lexeme
+/// until it meets a lexeme of the chunk.
+class ParallelFileParser {
+ public:
+  using size_type = std::string::size_type;
+
+  ParallelFileParser();
+  ParallelFileParser(const Settings& settings);
+  ParallelFileParser(Settings&& settings);
+  ParallelFileParser(const std::string& filename);
+  ParallelFileParser(const Settings& settings, const std::string& filename);
+  ParallelFileParser(Settings&& settings, const std::string& filename);
+  ParallelFileParser(const ParallelFileParser& other) = delete;
+  ParallelFileParser(ParallelFileParser&& other) noexcept = default;
+  ParallelFileParser& operator=(const ParallelFileParser& other) = delete;
+  ParallelFileParser& operator=(ParallelFileParser&& other) noexcept =
+      default;
+  virtual ~ParallelFileParser();
+
+  /// @brief Set the file that will be parsed. Files that can not be mapped
+  /// (pipes, devices) are read to memory.
+  void SetFile(const std::string& filename);
+
+  /// @brief Set settings.
+  void SetSettings(const Settings& settings);
+
+  /// @brief set settings.
+  void SetSettings(Settings&& settings);
+
+  /// @brief Set the count of threads.
+  /// @param threads default is std::thread::hardware_concurrency().
+  void SetThreads(size_type threads);
+
+  /// @brief Set the count of chars of a chunk, a chunk is extended to the
+  /// next boundary char.
+  /// @param chunk_size default is 4194304.
+  void SetChunkSize(size_type chunk_size);
+
+  const Settings& GetSettings() const;
+  Settings& GetSettings();
+  size_type GetThreads() const;
+  size_type GetChunkSize() const;
+
+  /// @brief Get the chars of the file.
+  std::string_view GetView() const;
+
+  /// @brief Append all lexemes of the file to the buffer in the file order,
+  /// the offsets are offsets in the file. The lines and the columns are
+  /// kept if buffer.IsTrackingPositions(). The threads count the newlines
+  /// of the chunks and write the lexemes of the chunks to the buffer.
+  /// @return Count of lexemes appended.
+  size_type Tokenize(TokenBuffer& buffer) const;
+
+ private:
+  /// @brief Chars [start_, end_) of the file and the lexemes that start in
+  /// them, next_i_ is the parsing index after the last lexeme.
+  struct Chunk {
+    size_type start_;
+    size_type end_;
+    size_type next_i_;
+    std::vector<Lexeme> lexemes_;
+    /// @brief Count of chars of the texts of the words.
+    size_type words_length_;
+    /// @brief Count of newlines of the chars and the offset after the last
+    /// one, counted if the positions are tracked.
+    size_type newlines_;
+    size_type line_start_;
+    /// @brief Index of the first lexeme and offset of the first word text
+    /// in the buffer.
+    size_type first_;
+    size_type word_offset_;
+    /// @brief Position of the chunk start.
+    Position base_;
+  };
+
+  static const size_type kDefaultChunkSize_;
+
+  /// @brief Cut the chars into chunks that end after boundary chars.
+  std::vector<Chunk> MakeChunks(const Settings& settings) const;
+
+  /// @brief Call function(chunk) for every chunk on the threads.
+  template <typename Function>
+  void ForEachChunk(std::vector<Chunk>& chunks, Function function) const;
+
+  /// @brief Get the lexemes that start in [chunk.start_, chunk.end_).
+  static void ParseChunk(StringParser& parser, Chunk& chunk);
+
+  /// @brief Parse the chunk again from i if the previous lexeme ends after
+  /// the chunk start, until a lexeme starts as a lexeme of the chunk.
+  static void FixChunk(StringParser& parser, Chunk& chunk, size_type i);
+
+  /// @brief Count the newlines of the chars of the chunk.
+  static void CountNewlines(std::string_view view, Chunk& chunk);
+
+  /// @brief Set the lexemes of the chunk in the buffer extended for them.
+  static void WriteChunk(std::string_view view, const Chunk& chunk,
+                         TokenBuffer& buffer);
+
+  Settings settings_;
+  MappedFile mapped_file_;
+  std::string file_str_;
+  size_type threads_;
+  size_type chunk_size_;
+};
+
+}  // namespace TokenParser
+
+#endif  // TOKEN_PARSER_PARALLEL_FILE_PARSER_H_
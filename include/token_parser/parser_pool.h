@@ -0,0 +1,91 @@
+#ifndef TOKEN_PARSER_PARSER_POOL_H_
+#define TOKEN_PARSER_PARSER_POOL_H_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "compiled_settings.h"
+#include "settings.h"
+
+namespace TokenParser {
+
+/// @brief Pool of parsers (StringParser, StreamParser, FileParser) that
+/// share one CompiledSettings. Acquire() gives an idle parser or constructs
+/// a new one, the parser returns to the pool reset (see Parser::Reset()) when
+/// the handle is destroyed, so its buffers are reused by the next input.
+/// @brief Acquire() may be called from several threads.
+template <typename Parser>
+class ParserPool {
+ public:
+  using parser_type = Parser;
+  using size_type = std::size_t;
+
+  /// @brief Parser acquired from the pool, returns it to the pool when
+  /// destroyed.
+  class Handle {
+   public:
+    Handle();
+    Handle(const Handle& other) = delete;
+    Handle(Handle&& other) noexcept = default;
+    Handle& operator=(const Handle& other) = delete;
+    Handle& operator=(Handle&& other) noexcept;
+    virtual ~Handle();
+
+    /// @brief Return the parser to the pool before the destruction.
+    void Release();
+
+    /// @brief Check if the handle has a parser.
+    explicit operator bool() const;
+
+    parser_type& operator*() const;
+    parser_type* operator->() const;
+    parser_type* Get() const;
+
+   private:
+    friend class ParserPool;
+
+    Handle(ParserPool* pool, std::unique_ptr<parser_type>&& parser);
+
+    ParserPool* pool_;
+    std::unique_ptr<parser_type> parser_;
+  };
+
+  ParserPool();
+  ParserPool(const Settings& settings);
+  ParserPool(CompiledSettings::Ptr settings);
+  ParserPool(const ParserPool& other) = delete;
+  ParserPool(ParserPool&& other) = delete;
+  ParserPool& operator=(const ParserPool& other) = delete;
+  ParserPool& operator=(ParserPool&& other) = delete;
+  virtual ~ParserPool();
+
+  /// @brief Get an idle parser or construct a new one.
+  /// @warning The pool must outlive the handle.
+  Handle Acquire();
+
+  /// @brief Keep at most max_idle parsers, the others are destroyed when
+  /// returned.
+  /// @param max_idle default is unlimited.
+  void SetMaxIdle(size_type max_idle);
+
+  size_type GetMaxIdle() const;
+  size_type GetIdleCount() const;
+  const CompiledSettings::Ptr& GetCompiledSettings() const;
+
+ private:
+  /// @brief Reset the parser and keep it for the next Acquire().
+  void Return(std::unique_ptr<parser_type>&& parser);
+
+  CompiledSettings::Ptr settings_;
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<parser_type>> idle_;
+  size_type max_idle_;
+};
+
+}  // namespace TokenParser
+
+#include "../../src/parser_pool.inc"
+
+#endif  // TOKEN_PARSER_PARSER_POOL_H_
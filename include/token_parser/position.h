@@ -0,0 +1,48 @@
+#ifndef TOKEN_PARSER_POSITION_H_
+#define TOKEN_PARSER_POSITION_H_
+
+#include <string>
+#include <type_traits>
+
+namespace TokenParser {
+
+/// @brief Position of a char in the source: the offset of the char, its
+/// line and its column. Lines and columns start from 1, a column is counted
+/// in chars, a newline char is the last char of its line.
+class Position {
+ public:
+  using size_type = std::string::size_type;
+
+  /// @brief Construct the position of the first char.
+  Position();
+
+  Position(size_type offset, size_type line, size_type column);
+
+  Position(const Position& other) = default;
+  Position(Position&& other) noexcept = default;
+  Position& operator=(const Position& other) = default;
+  Position& operator=(Position&& other) noexcept = default;
+
+  ~Position() = default;
+
+  bool operator==(const Position& other) const;
+  bool operator!=(const Position& other) const;
+
+  /// @brief Get the offset of the char in the source.
+  size_type GetOffset() const;
+
+  size_type GetLine() const;
+  size_type GetColumn() const;
+
+ private:
+  size_type offset_;
+  size_type line_;
+  size_type column_;
+};
+
+static_assert(std::is_trivially_copyable_v<Position>,
+              "Position must be trivially copyable");
+
+}  // namespace TokenParser
+
+#endif  // TOKEN_PARSER_POSITION_H_
@@ -0,0 +1,74 @@
+#ifndef TOKEN_PARSER_READ_AHEAD_STREAMBUF_H_
+#define TOKEN_PARSER_READ_AHEAD_STREAMBUF_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace TokenParser {
+
+/// @brief Input stream buffer that reads the source by a thread. The thread
+/// fills a ring of blocks while the reader takes chars of the filled ones,
+/// so waiting for the source overlaps with parsing. At most count blocks
+/// are filled ahead, the block taken by the reader is one of them.
+class ReadAheadStreambuf : public std::streambuf {
+ public:
+  using size_type = std::string::size_type;
+
+  ReadAheadStreambuf();
+  ReadAheadStreambuf(const ReadAheadStreambuf& other) = delete;
+  ReadAheadStreambuf(ReadAheadStreambuf&& other) = delete;
+  ReadAheadStreambuf& operator=(const ReadAheadStreambuf& other) = delete;
+  ReadAheadStreambuf& operator=(ReadAheadStreambuf&& other) = delete;
+  virtual ~ReadAheadStreambuf();
+
+  /// @brief Start reading the source by a thread, the previous source is
+  /// closed. The memory of the blocks is reused.
+  /// @param buff_size count of chars of a block.
+  /// @param count count of blocks, at least 2 to read while the reader
+  /// takes chars.
+  /// @warning The source must be alive until Close() and must not be used
+  /// by others.
+  void Open(std::streambuf* source, size_type buff_size, size_type count);
+
+  /// @brief Stop the thread and drop the read chars.
+  void Close();
+
+  bool IsOpen() const;
+
+ protected:
+  int_type underflow() override;
+
+ private:
+  struct Block {
+    std::vector<char> chars_;
+    size_type size_;
+  };
+
+  static const size_type kMinCount_;
+
+  /// @brief Fill the free blocks until the source is end or Close().
+  void Produce();
+
+  std::streambuf* source_;
+  std::vector<Block> blocks_;
+  /// @brief Block taken by the reader or the next one to take.
+  size_type head_;
+  /// @brief Count of filled blocks from head_.
+  size_type filled_;
+  /// @brief The reader takes chars of blocks_[head_].
+  bool reading_;
+  bool end_;
+  bool stop_;
+  std::mutex mutex_;
+  std::condition_variable filled_cv_;
+  std::condition_variable free_cv_;
+  std::thread thread_;
+};
+
+}  // namespace TokenParser
+
+#endif  // TOKEN_PARSER_READ_AHEAD_STREAMBUF_H_
@@ -1,9 +1,14 @@
 #ifndef TOKEN_PARSER_SETTINGS_H_
 #define TOKEN_PARSER_SETTINGS_H_
 
+#include <array>
 #include <map>
 #include <string>
 
+#include "char_set.h"
+#include "id_index.h"
+#include "keyword_hash.h"
+#include "keyword_trie.h"
 #include "token.h"
 
 namespace TokenParser {
@@ -13,6 +18,15 @@ class Settings {
   using id_type = Token::id_type;
   using TokenIds = std::map<id_type, std::string>;
   using AppropriateQuotes = std::map<char, char>;
+  using CharClasses = std::array<unsigned char, 256>;
+  using CloseQuotes = std::array<char, 256>;
+
+  /// @brief Flags of CharClasses.
+  enum CharClass : unsigned char {
+    kCharClassSpace = 1,
+    kCharClassWordDelim = 2,
+    kCharClassQoute = 4,
+  };
 
   Settings();
   Settings(const Settings& other) = default;
@@ -51,6 +65,12 @@ class Settings {
   /// @param token_id_is_full_word default is true.
   void SetTokenIdIsFullWord(bool token_id_is_full_word);
 
+  /// @brief Flag indicating that NextId() takes the longest id that matches
+  /// (e.g. "<=" rather than "<", "int32_t" rather than "int"). If false, the
+  /// smallest id that matches is taken.
+  /// @param token_id_longest_match default is false.
+  void SetTokenIdLongestMatch(bool token_id_longest_match);
+
   /// @brief Flag indicating that the word may by surronded by qoutes.
   /// @brief Example: str = "word = 'word with spaces' ", with GetI() == 5,
   /// NextWord() == "'word with spaces'".
@@ -67,7 +87,14 @@ class Settings {
   /// @param appropriate_quotes default is {{'"', '"'}, {'\''. '\''}}.
   void SetAppropriateQuotes(AppropriateQuotes&& appropriate_quotes);
 
+  /// @warning Token ids changed through the returned reference are compiled
+  /// again on the next GetKeywordTrie(), GetKeywordHash() or GetIdIndex(),
+  /// do not keep the reference between parsing calls.
   TokenIds& GetTokenIds();
+
+  /// @warning Chars changed through the returned reference are classified
+  /// again on the next GetCharClasses(), do not keep the reference between
+  /// parsing calls.
   std::string& GetSpaceChars();
   std::string& GetWordDelimChars();
   AppropriateQuotes& GetAppropriateQuotes();
@@ -76,23 +103,68 @@ class Settings {
   const std::string& GetSpaceChars() const;
   const std::string& GetWordDelimChars() const;
   bool GetTokenIdIsFullWord() const;
+  bool GetTokenIdLongestMatch() const;
   bool GetWordMaySurrondedByQoutes() const;
   const AppropriateQuotes& GetAppropriateQuotes() const;
 
+  /// @brief Token ids compiled to the prefix tree.
+  const KeywordTrie& GetKeywordTrie() const;
+
+  /// @brief Token ids compiled to the hash table of whole words.
+  const KeywordHash& GetKeywordHash() const;
+
+  /// @brief Token ids compiled to the index from id to text.
+  const IdIndex& GetIdIndex() const;
+
+  /// @brief Table of CharClass flags of every char (indexed by unsigned
+  /// char), built from space chars, word delim chars and appropriate quotes.
+  const CharClasses& GetCharClasses() const;
+
+  /// @brief Table of close qoutes (indexed by unsigned open qoute char).
+  const CloseQuotes& GetCloseQuotes() const;
+
+  /// @brief Space chars for vectorized search.
+  const CharSet& GetSpaceCharSet() const;
+
+  /// @brief Word delim chars for vectorized search.
+  const CharSet& GetWordDelimCharSet() const;
+
+  /// @brief Chars after which the text may be cut into blocks: word delim
+  /// chars that are space chars too and can not be inside a number, or the
+  /// first word delim char if there are no such chars.
+  const std::string& GetBoundaryChars() const;
+
  private:
   static const TokenIds kDefaultTokenIds_;
   static const std::string kDefaultSpaceChars_;
   static const std::string kDefaultWordDelimChars_;
   static const bool kDefaultTokenIdIsFullWord_;
+  static const bool kDefaultTokenIdLongestMatch_;
   static const bool kDefaultWordMaySurroundedByQoutes_;
   static const AppropriateQuotes kDefaultAppropriateQuotes_;
 
+  void BuildKeywords() const;
+  void BuildCharClasses() const;
+
   TokenIds token_ids_;
   std::string space_chars_;
   std::string word_delim_chars_;
   bool token_id_is_full_word_;
+  bool token_id_longest_match_;
   bool word_may_surrounded_by_qoutes_;
   AppropriateQuotes appropriate_quotes_;
+
+  mutable KeywordTrie keyword_trie_;
+  mutable KeywordHash keyword_hash_;
+  mutable IdIndex id_index_;
+  mutable bool keywords_dirty_;
+
+  mutable CharClasses char_classes_;
+  mutable CloseQuotes close_quotes_;
+  mutable CharSet space_char_set_;
+  mutable CharSet word_delim_char_set_;
+  mutable std::string boundary_chars_;
+  mutable bool char_classes_dirty_;
 };
 
 }  // namespace TokenParser
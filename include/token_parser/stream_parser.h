@@ -72,10 +72,16 @@ USAGE:
 
 #include <istream>
 #include <string>
+#include <string_view>
+#include <vector>
 
+#include "compiled_settings.h"
+#include "lexeme.h"
+#include "position.h"
 #include "settings.h"
 #include "string_parser.h"
 #include "token.h"
+#include "token_buffer.h"
 
 namespace TokenParser {
 
@@ -94,34 +100,80 @@ class StreamParser {
   StreamParser(stream_type* stream);
   StreamParser(const Settings& settings, stream_type* stream);
   StreamParser(Settings&& settings, stream_type* stream);
+  StreamParser(CompiledSettings::Ptr settings);
+  StreamParser(CompiledSettings::Ptr settings, stream_type* stream);
   StreamParser(const StreamParser& other) = default;
   StreamParser(StreamParser&& other) noexcept = default;
   StreamParser& operator=(const StreamParser& other) = default;
   StreamParser& operator=(StreamParser&& other) noexcept = default;
   virtual ~StreamParser();
 
-  /// @brief Set the string that will be parsed.
+  /// @brief Set the string that will be parsed. The memory of the buffer is
+  /// kept, so a parser reused for many streams does not allocate again.
   void SetStream(stream_type* str);
 
+  /// @brief Parse the chars of the buffer instead of a stream, the chars are
+  /// not copied (e.g. a memory mapped file).
+  /// @warning The buffer must outlive the parsing.
+  void SetBuffer(std::string_view buffer);
+
+  /// @brief Drop the stream and the buffered chars to reuse the parser for
+  /// the next input. The settings and the memory of the buffer are kept.
+  void Reset();
+
+  /// @brief Free the memory of the buffer that is not used now.
+  void ShrinkToFit();
+
+  /// @brief Set the count of chars that are read from the stream at once.
+  /// Chars after the last word boundary of the block are kept for the next
+  /// block, so a block is extended while it has no boundary.
+  /// @param buff_size default is 65536.
+  void SetBuffSize(size_type buff_size);
+
   /// @brief Set settings.
   void SetSettings(const Settings& settings);
 
   /// @brief set settings.
   void SetSettings(Settings&& settings);
 
+  /// @brief Set settings shared with other parsers, copies the pointer.
+  void SetSettings(CompiledSettings::Ptr settings);
+
   stream_type* GetStream() const;
 
   /// @brief Get current buffered-string from stream.
+  /// @warning Empty if the chars are set by SetBuffer(), may contain chars
+  /// of the next block after GetView(), use GetView().
   const std::string* GetStr() const;
 
+  /// @brief Get current buffered chars, GetI() is the index in them.
+  std::string_view GetView() const;
+
   /// @brief Get index current buffered-string from stream.
   size_type GetI() const;
 
+  size_type GetBuffSize() const;
+
+  /// @brief Get the offset of the buffered chars (GetView()) in the stream.
+  size_type GetViewOffset() const;
+
+  /// @brief Get the settings, see StringParser::GetSettings().
   const Settings& GetSettings() const;
-  Settings& GetSettings();
+
+  /// @brief Get the settings to share them with other parsers.
+  const CompiledSettings::Ptr& GetCompiledSettings() const;
+
+  /// @brief Get the position of the char at i (GetI()), the offset is the
+  /// offset in the stream.
+  Position GetPosition() const;
+
+  /// @brief Get the position of the buffered char at index i, e.g. of
+  /// Lexeme::GetStart(), see StringParser::GetPosition().
+  Position GetPosition(size_type i) const;
 
   /// @brief Check if stream is end or contain only space chars
-  /// (settings.GetSpaceChars()).
+  /// (settings.GetSpaceChars()). A stream that failed to read (badbit) ends
+  /// too, the caller checks its state to tell a read error from the end.
   bool IsEnd() const;
 
   /// @brief Get the next word. Word is a substring limited by word delim chars
@@ -129,6 +181,12 @@ class StreamParser {
   /// @return Next word or empty string if no word next.
   std::string NextWord();
 
+  /// @brief Get the next word as NextWord() does, but without copying it.
+  /// @warning The view points into the buffered-string (GetStr()), it is
+  /// valid until the next call of a Next* method.
+  /// @return Next word or empty view if no word next.
+  std::string_view NextWordView();
+
   /// @brief Get next int-token.
   /// @return Next int-token or null-token if no int next.
   Token NextInt();
@@ -150,23 +208,104 @@ class StreamParser {
   /// @return Next this id-token or null-token if no this id next.
   Token NextThisId(Token::id_type id);
 
+  /// @brief Get the next lexeme as StringParser::NextAny() does.
+  /// @warning The text of the lexeme points into the buffered chars
+  /// (GetView()), it is valid until the next call of a Next* method.
+  /// @return Next lexeme or end-lexeme if the stream is end.
+  Lexeme NextAny();
+
+  /// @brief Get the next lexemes as StringParser::NextAny() does. The
+  /// lexemes are taken from the current buffered chars, the buffer is read
+  /// again only before the first one.
+  /// @warning The texts of the lexemes point into the buffered chars
+  /// (GetView()), they are valid until the next call of a Next* method.
+  /// @return Count of lexemes written to lexemes, 0 only if the stream is
+  /// end.
+  size_type NextBatch(Lexeme* lexemes, size_type count);
+
+  /// @brief Append the next lexemes to the buffer as NextAny() does, the
+  /// offsets are offsets in the stream. The lines and the columns are kept
+  /// if buffer.IsTrackingPositions().
+  /// @return Count of lexemes appended, less than count only if the stream
+  /// is end.
+  size_type NextBatch(TokenBuffer& buffer, size_type count);
+
+  /// @brief Get the next id-token as NextId() does, without moving i. The
+  /// result is kept for NextId() at the same i, the chars that were read
+  /// to peek are kept in the buffer.
+  /// @return Next id-token or null-token if no id next.
+  Token PeekId();
+
+  /// @brief Get the next word as NextWord() does, without moving i. The
+  /// result is kept for NextWord() at the same i.
+  /// @return Next word or empty string if no word next.
+  std::string PeekWord();
+
+  /// @brief PeekWord() without copying the word.
+  /// @warning The view points into the buffered chars (GetView()), it is
+  /// valid until the next call of a Next* method.
+  std::string_view PeekWordView();
+
+  /// @brief Get the next lexeme as NextAny() does, without moving i. The
+  /// result is kept for NextAny(), NextId() and NextWord() at the same i.
+  /// @warning The text of the lexeme points into the buffered chars
+  /// (GetView()), it is valid until the next call of a Next* method.
+  /// @return Next lexeme or end-lexeme if the stream is end.
+  Lexeme PeekAny();
+
  private:
   using WordIdx = StringParser::WordIdx;
 
+  static const size_type kDefaultBuffSize_;
+
+  /// @brief Get the settings for parsing, never copies them.
+  const Settings& ParsingSettings() const;
+
   /// @brief true if we can parse further, false if all end.
   bool CheckBuffOrUpdate();
-  void UpdateBuff(char_type delim);
+
+  /// @brief Drop the parsed chars and parse the next block.
+  void UpdateBuff();
+
+  /// @brief Extend the parsed chars up to the delim, reading blocks.
   void AppendBuff(char_type delim);
 
+  /// @brief Append up to buff_size_ chars of the stream to buff_.
+  void ReadBlock();
+
+  /// @brief Get the end of the last boundary char of buff_ at or after from
+  /// (see Settings::GetBoundaryChars()) that does not cut an id.
+  /// @param cut_end end of the last boundary char at or after from even if
+  /// it cuts an id, or 0.
+  /// @return End of the boundary char or 0 if there is no boundary.
+  size_type BoundaryEnd(size_type from, size_type& cut_end) const;
+
+  /// @brief Check if an id of the chars of buff_ goes on after end, or the
+  /// chars up to the end of buff_ are a prefix of an id, so the block must
+  /// not be cut at end.
+  bool IsIdCut(size_type end) const;
+
   bool HasChar(size_type start, char_type ch) const;
 
-  std::string NextWordQouted(size_type start);
+  /// @brief Check if the next word is quoted and its close qoute is not in
+  /// the buffer yet, so the buffer must grow to take it.
+  /// @param cq the close qoute.
+  bool IsQoutedWordCut(size_type start, char& cq) const;
+
+  /// @brief Read the chars up to the close qoute of the quoted word at
+  /// start.
+  void ReadQoutedWord(size_type start);
+
+  std::string_view NextWordQouted(size_type start);
   Token NextIdQouted(size_type start);
   Token NextThisIdQouted(size_type start, Token::id_type id);
 
   StringParser string_parser_;
   std::basic_istream<char_type>* stream_;
   std::string buff_;
+  std::vector<char_type> block_;
+  size_type buff_size_;
+  size_type buff_offset_;
 };
 
 }  // namespace TokenParser
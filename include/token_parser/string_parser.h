@@ -71,9 +71,15 @@ USAGE:
 #define TOKEN_PARSER_STRING_PARSER_H_
 
 #include <string>
+#include <string_view>
 
+#include "compiled_settings.h"
+#include "lexeme.h"
+#include "line_counter.h"
+#include "position.h"
 #include "settings.h"
 #include "token.h"
+#include "token_buffer.h"
 
 namespace TokenParser {
 
@@ -88,11 +94,20 @@ class StringParser {
 
   StringParser();
   StringParser(const std::string* str, size_type i = 0);
+  StringParser(std::string_view str, size_type i = 0);
   StringParser(const Settings& settings);
   StringParser(const Settings& settings, const std::string* str,
                size_type i = 0);
+  StringParser(const Settings& settings, std::string_view str,
+               size_type i = 0);
   StringParser(Settings&& settings);
   StringParser(Settings&& settings, const std::string* str, size_type i = 0);
+  StringParser(Settings&& settings, std::string_view str, size_type i = 0);
+  StringParser(CompiledSettings::Ptr settings);
+  StringParser(CompiledSettings::Ptr settings, const std::string* str,
+               size_type i = 0);
+  StringParser(CompiledSettings::Ptr settings, std::string_view str,
+               size_type i = 0);
   StringParser(const StringParser& other) = default;
   StringParser(StringParser&& other) noexcept = default;
   StringParser& operator=(const StringParser& other) = default;
@@ -102,19 +117,66 @@ class StringParser {
   /// @brief Set the string that will be parsed. Sets i = 0.
   void SetStr(const std::string* str);
 
+  /// @brief Set the chars that will be parsed, e.g. a slice of a network
+  /// buffer or of a mapped file. Sets i = 0.
+  /// @warning The chars are not copied, they must be alive and not changed
+  /// while parsing. GetStr() is nullptr.
+  void SetStr(std::string_view str);
+
+  /// @brief Set the chars [data, data + size) that will be parsed. Sets i = 0.
+  /// @warning The chars are not copied, they must be alive and not changed
+  /// while parsing. GetStr() is nullptr.
+  void SetStr(const char* data, size_type size);
+
   /// @brief Set the index from which the next parsing will be performed.
+  /// The kept start of the next lexeme and the peeked lexeme are dropped,
+  /// so the chars may be changed in place before it.
   void SetI(size_type i);
 
+  /// @brief Set the position of the first parsing char, e.g. if the chars
+  /// are a part of a file. SetStr() sets the first position of a source.
+  void SetBasePosition(const Position& position);
+
+  /// @brief Drop the parsing chars and set i = 0 to reuse the parser for the
+  /// next input. The settings are kept, nothing is allocated.
+  void Reset();
+
   /// @brief Set settings.
   void SetSettings(const Settings& settings);
 
   /// @brief set settings.
   void SetSettings(Settings&& settings);
 
+  /// @brief Set settings shared with other parsers, copies the pointer.
+  void SetSettings(CompiledSettings::Ptr settings);
+
+  /// @brief Get the parsing string or nullptr if chars are set by view.
   const std::string* GetStr() const;
+
+  /// @brief Get the parsing chars.
+  std::string_view GetView() const;
+
   size_type GetI() const;
+
+  /// @brief Get the settings, the shared settings are never changed. To
+  /// change them copy, edit and commit the copy by SetSettings():
+  /// @code
+  /// Settings settings = parser.GetSettings();
+  /// settings.SetSpaceChars(" ");
+  /// parser.SetSettings(std::move(settings));
+  /// @endcode
   const Settings& GetSettings() const;
-  Settings& GetSettings();
+
+  /// @brief Get the settings to share them with other parsers.
+  const CompiledSettings::Ptr& GetCompiledSettings() const;
+
+  /// @brief Get the position of the char at i (GetI()).
+  Position GetPosition() const;
+
+  /// @brief Get the position of the parsing char at index i, e.g. of
+  /// Lexeme::GetStart(). The newlines are counted from the last asked index,
+  /// so asking in the parsing order counts every char once.
+  Position GetPosition(size_type i) const;
 
   /// @brief Check if parsing str is end or contain only space chars
   /// (settings.GetSpaceChars()).
@@ -125,6 +187,12 @@ class StringParser {
   /// @return Next word or empty string if no word next.
   std::string NextWord();
 
+  /// @brief Get the next word as NextWord() does, but without copying it.
+  /// @warning The view points into the parsing str, it is valid while the str
+  /// is alive and not changed.
+  /// @return Next word or empty view if no word next.
+  std::string_view NextWordView();
+
   /// @brief Get next int-token.
   /// @return Next int-token or null-token if no int next.
   Token NextInt();
@@ -146,10 +214,65 @@ class StringParser {
   /// @return Next this id-token or null-token if no this id next.
   Token NextThisId(Token::id_type id);
 
+  /// @brief Get the next lexeme, it is classified once instead of trying
+  /// Next* methods one by one: an id if an id matches (as NextId()), a
+  /// number if it starts with a digit (a float if it has a fraction or an
+  /// exponent, an int if it is negative, an uint otherwise), a word (as
+  /// NextWord()) otherwise.
+  /// @warning The text of the lexeme points into the parsing str, it is
+  /// valid while the str is alive and not changed.
+  /// @return Next lexeme or end-lexeme if the str is end.
+  Lexeme NextAny();
+
+  /// @brief Get the next lexemes as NextAny() does.
+  /// @warning The texts of the lexemes point into the parsing str, they are
+  /// valid while the str is alive and not changed.
+  /// @return Count of lexemes written to lexemes, less than count only if
+  /// the str is end.
+  size_type NextBatch(Lexeme* lexemes, size_type count);
+
+  /// @brief Append the next lexemes to the buffer as NextAny() does, the
+  /// offsets are indexes in the parsing str. If
+  /// buffer.IsTrackingPositions() the lines and the columns are kept as
+  /// GetPosition() gives them, the offsets then count from the base
+  /// position (SetBasePosition()).
+  /// @return Count of lexemes appended, less than count only if the str is
+  /// end.
+  size_type NextBatch(TokenBuffer& buffer, size_type count);
+
+  /// @brief Get the next id-token as NextId() does, without moving i. The
+  /// result is kept, so NextId() or NextThisId() at the same i takes it
+  /// without parsing again. The kept result is valid until i or the chars
+  /// change: it is dropped by SetI(), SetStr() and the settings change.
+  /// @return Next id-token or null-token if no id next.
+  Token PeekId();
+
+  /// @brief Get the next word as NextWord() does, without moving i. The
+  /// result is kept for NextWord() at the same i, see PeekId().
+  /// @return Next word or empty string if no word next.
+  std::string PeekWord();
+
+  /// @brief PeekWord() without copying the word, see NextWordView().
+  std::string_view PeekWordView();
+
+  /// @brief Get the next lexeme as NextAny() does, without moving i. The
+  /// result is kept for NextAny(), NextId() and NextWord() at the same i,
+  /// see PeekId().
+  /// @return Next lexeme or end-lexeme if the str is end.
+  Lexeme PeekAny();
+
  protected:
   template <typename CharT>
   friend class StreamParser;
 
+  /// @brief SetStr() for chars that begin with the parsing chars, e.g. the
+  /// same chars moved or extended. The counted positions are kept.
+  void ExtendStr(const char* data, size_type size);
+
+  /// @brief Set the lines and the columns of the lexemes of the buffer from
+  /// first, the lexemes of the parsing chars appended without them.
+  void CountPositions(TokenBuffer& buffer, size_type first) const;
+
   struct WordIdx {
     size_type start_;
     size_type len_;
@@ -158,22 +281,120 @@ class StringParser {
   bool IsSpace(char ch) const;
   bool IsWordDelim(char ch) const;
   bool IsQoute(char ch) const;
+  bool IsCharClass(char ch, unsigned char char_class) const;
+
+  /// @brief Get the close qoute for the open qoute ch.
+  char CloseQoute(char ch) const;
+
+  /// @brief Get the index of the first not space char from i. The result is
+  /// cached until i, the parsing chars or the settings change.
   size_type NextParsingStart() const;
 
+  /// @brief Find the id that matches str from i, as NextId() takes it.
+  /// @return false if no id matches.
+  bool IdAt(size_type i, Token::id_type& id, size_type& len) const;
+
+  /// @brief Classify the number that starts at i, see NextAny().
+  /// @return Number-token or null-token if no number starts at i.
+  Token NumberAt(size_type i, size_type& len) const;
+
   Token::int_type StrToInt(size_type start, size_type& len) const;
   Token::uint_type StrToUint(size_type start, size_type& len) const;
   Token::float_type StrToFloat(size_type start, size_type& len) const;
 
-  bool IsIdNext(size_type i, const std::string& word) const;
+  bool IsIdNext(size_type i, std::string_view word) const;
+
+  /// @brief Check if the id of len chars, that matches str from i, ends
+  /// properly (see Settings::SetTokenIdIsFullWord).
+  bool IsIdEnd(size_type i, size_type len) const;
 
   WordIdx NextWordIdx() const;
+  WordIdx WordIdxAt(size_type start) const;
   WordIdx NextWordIdxQouted(size_type start) const;
   std::string WordIdxToString(const WordIdx& word_idx) const;
+  std::string_view WordIdxToView(const WordIdx& word_idx) const;
 
  private:
-  Settings settings_;
+  struct NumberBuff {
+    char small_[64];
+    std::string big_;
+  };
+
+  /// @brief Lexemes peeked at i_ of the chars [data_, data_ + length_).
+  struct PeekMemo {
+    size_type i_;
+    const char* data_;
+    size_type length_;
+
+    bool has_id_;
+    bool id_found_;
+    Token::id_type id_;
+    size_type id_len_;
+
+    bool has_word_;
+    WordIdx word_idx_;
+
+    bool has_any_;
+    Lexeme any_;
+  };
+
+  /// @brief Get the settings for parsing.
+  const Settings& ParsingSettings() const;
+
+  /// @brief Drop the cached NextParsingStart() and the peeked lexemes.
+  void InvalidateCache();
+
+  /// @brief Get the peeked lexemes at i, dropping the ones peeked before at
+  /// other i.
+  PeekMemo& MemoAtI();
+
+  /// @brief Get the peeked lexemes if they were peeked at i.
+  /// @return nullptr if nothing was peeked at i.
+  const PeekMemo* FindMemo() const;
+
+  /// @brief Get the peeked id at i, from PeekId() or PeekAny().
+  /// @return false if nothing was peeked at i.
+  bool MemoId(bool& found, Token::id_type& id, size_type& len) const;
+  static bool MemoId(const PeekMemo& memo, bool& found, Token::id_type& id,
+                     size_type& len);
+
+  /// @brief Get the peeked word at i, from PeekWord() or PeekAny().
+  /// @return false if no word was peeked at i.
+  bool MemoWord(WordIdx& word_idx) const;
+
+  bool HasStr() const;
+  std::string_view Str() const;
+
+  /// @brief Get NUL-terminated chars from start for strto* functions.
+  const char* NumberCStr(size_type start, NumberBuff& buff) const;
+  static bool IsNumberChar(char ch);
+
+  /// @brief Check if [first, last) starts with "inf" or "nan" in any case.
+  static bool IsInfOrNan(const char* first, const char* last);
+
+  static const char* SkipNumberSpacesAndSign(const char* first,
+                                             const char* last, bool& negative);
+
+  /// @brief Parse decimal digits. overflow is true if the value does not fit
+  /// in uint_type.
+  /// @return Pointer after the digits.
+  static const char* ParseDigits(const char* first, const char* last,
+                                 Token::uint_type& value, bool& overflow);
+  static bool IsDigit(char ch);
+
+  CompiledSettings::Ptr settings_;
   const std::string* str_;
+  std::string_view view_;
   size_type i_;
+
+  mutable size_type cached_i_;
+  mutable size_type cached_start_;
+  mutable const char* cached_data_;
+  mutable size_type cached_length_;
+
+  PeekMemo memo_;
+
+  mutable LineCounter line_counter_;
 };
 
 }  // namespace TokenParser
@@ -2,10 +2,13 @@
 #define TOKEN_PARSER_TOKEN_H_
 
 #include <cstdint>
+#include <type_traits>
 
 namespace TokenParser {
 
 /// @brief Contains one of: nothing(null), int, uint, float, id;
+/// @brief Token is trivially copyable (it may be copied by memcpy) and takes
+/// 16 bytes: the type and the 8-byte value.
 class Token {
  public:
   using int_type = int64_t;
@@ -13,7 +16,7 @@ class Token {
   using float_type = double;
   using id_type = int;
 
-  enum Type {
+  enum Type : uint8_t {
     kTypeNull,
     kTypeInt,
     kTypeUint,
@@ -44,7 +47,7 @@ class Token {
   Token& operator=(const Token& other) = default;
   Token& operator=(Token&& other) noexcept = default;
 
-  virtual ~Token();
+  ~Token() = default;
 
   bool operator==(const Token& other) const;
   bool operator!=(const Token& other) const;
@@ -103,6 +106,12 @@ class Token {
   };
 };
 
+static_assert(sizeof(Token) <= 16, "Token must be at most 16 bytes");
+static_assert(std::is_trivially_copyable_v<Token>,
+              "Token must be trivially copyable");
+static_assert(std::is_standard_layout_v<Token>,
+              "Token must be standard layout");
+
 }  // namespace TokenParser
 
 #endif  // TOKEN_PARSER_TOKEN_H_
@@ -0,0 +1,192 @@
+#ifndef TOKEN_PARSER_TOKEN_BUFFER_H_
+#define TOKEN_PARSER_TOKEN_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "lexeme.h"
+#include "line_counter.h"
+#include "position.h"
+#include "token.h"
+
+namespace TokenParser {
+
+class StringParser;
+template <typename CharT>
+class StreamParser;
+
+/// @brief Lexemes stored as structure of arrays: types, 8-byte payloads,
+/// source offsets and lengths. Types may be scanned without touching the
+/// payloads. A word has kTypeNull type and non-zero length, its text is
+/// copied to the buffer and its payload is the offset of the text there.
+/// @brief The lines and the columns of the lexemes are kept as two more
+/// arrays if SetTrackPositions(true), the parsers fill them by NextBatch().
+/// @brief Iteration yields Token (null-token for words).
+class TokenBuffer {
+ public:
+  using size_type = std::string::size_type;
+  using payload_type = uint64_t;
+
+  class ConstIterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Token;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Token*;
+    using reference = Token;
+
+    ConstIterator(const TokenBuffer* buffer, size_type i);
+
+    Token operator*() const;
+    ConstIterator& operator++();
+    ConstIterator operator++(int);
+    bool operator==(const ConstIterator& other) const;
+    bool operator!=(const ConstIterator& other) const;
+
+   private:
+    const TokenBuffer* buffer_;
+    size_type i_;
+  };
+
+  TokenBuffer();
+  TokenBuffer(const TokenBuffer& other) = default;
+  TokenBuffer(TokenBuffer&& other) noexcept = default;
+  TokenBuffer& operator=(const TokenBuffer& other) = default;
+  TokenBuffer& operator=(TokenBuffer&& other) noexcept = default;
+  virtual ~TokenBuffer();
+
+  /// @brief Append the lexeme, the text of a word is copied.
+  /// @param base offset of the parsing chars in the source, the offset of
+  /// the lexeme is base + lexeme.GetStart().
+  void PushBack(const Lexeme& lexeme, size_type base = 0);
+
+  /// @brief Append the lexeme at the position, the offset of the lexeme is
+  /// position.GetOffset().
+  void PushBack(const Lexeme& lexeme, const Position& position);
+
+  /// @brief Keep the lines and the columns of the lexemes appended with a
+  /// position. The lexemes appended without it get line and column 0.
+  /// @param track default is false.
+  void SetTrackPositions(bool track);
+
+  bool IsTrackingPositions() const;
+
+  /// @brief Reserve memory for count lexemes.
+  void Reserve(size_type count);
+
+  void Clear();
+  size_type Size() const;
+  bool Empty() const;
+
+  Token::Type GetType(size_type i) const;
+  Token GetToken(size_type i) const;
+
+  /// @brief Get the offset of the lexeme in the source.
+  size_type GetOffset(size_type i) const;
+
+  /// @brief Get the count of chars of the lexeme in the source.
+  size_type GetLength(size_type i) const;
+
+  /// @brief Get the position of the lexeme in the source.
+  /// @warning Undefined behavior if IsTrackingPositions() == false.
+  Position GetPosition(size_type i) const;
+
+  bool IsWord(size_type i) const;
+
+  /// @brief Get the text of the word.
+  /// @warning Undefined behavior if IsWord(i) == false.
+  std::string_view GetWord(size_type i) const;
+
+  /// @brief Get the arrays, each one has Size() elements. The lines and
+  /// the columns are empty if IsTrackingPositions() == false.
+  const Token::Type* GetTypes() const;
+  const payload_type* GetPayloads() const;
+  const size_type* GetOffsets() const;
+  const size_type* GetLengths() const;
+  const size_type* GetLines() const;
+  const size_type* GetColumns() const;
+
+  ConstIterator begin() const;
+  ConstIterator end() const;
+
+ private:
+  friend class ParallelFileParser;
+  friend class StringParser;
+  template <typename CharT>
+  friend class StreamParser;
+
+  /// @brief Allocator that leaves the elements appended by resize()
+  /// uninitialized, so the arrays extended by Extend() are first written by
+  /// the threads that set the lexemes.
+  template <typename T>
+  struct UninitAllocator : std::allocator<T> {
+    template <typename U>
+    struct rebind {
+      using other = UninitAllocator<U>;
+    };
+
+    UninitAllocator() = default;
+    template <typename U>
+    UninitAllocator(const UninitAllocator<U>& other) noexcept
+        : std::allocator<T>(other) {}
+
+    template <typename U>
+    void construct(U* p) noexcept {
+      ::new (static_cast<void*>(p)) U;
+    }
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+      ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+  };
+
+  template <typename T>
+  using Array = std::vector<T, UninitAllocator<T>>;
+
+  /// @brief Append the lexeme without the line and the column.
+  /// @warning The lines and the columns must be set by CountPositions() if
+  /// IsTrackingPositions().
+  void PushLexeme(const Lexeme& lexeme, size_type offset);
+
+  /// @brief Set the lines and the columns of the lexemes from first,
+  /// appended by PushLexeme(), in one pass of the line counter over the
+  /// chars str.
+  void CountPositions(size_type first, std::string_view str,
+                      LineCounter& line_counter);
+
+  /// @brief Append count lexemes to be set by SetLexeme() and words_length
+  /// chars for the texts of their words.
+  void Extend(size_type count, size_type words_length);
+
+  /// @brief Set the lexeme i appended by Extend(), the text of a word is
+  /// copied to the chars of the words from word_offset. Several threads may
+  /// set different lexemes at once.
+  /// @param offset offset of the lexeme in the source.
+  void SetLexeme(size_type i, const Lexeme& lexeme, size_type word_offset,
+                 size_type offset);
+
+  /// @brief SetLexeme() at the position, the offset of the lexeme is
+  /// position.GetOffset().
+  void SetLexeme(size_type i, const Lexeme& lexeme, size_type word_offset,
+                 const Position& position);
+
+  Array<Token::Type> types_;
+  Array<payload_type> payloads_;
+  Array<size_type> offsets_;
+  Array<size_type> lengths_;
+  Array<size_type> lines_;
+  Array<size_type> columns_;
+  Array<char> words_;
+  bool track_positions_;
+};
+
+}  // namespace TokenParser
+
+#endif  // TOKEN_PARSER_TOKEN_BUFFER_H_
@@ -0,0 +1,504 @@
+#include "../include/token_parser/async_file_streambuf.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TOKEN_PARSER_ASYNC_FILE_POSIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define TOKEN_PARSER_ASYNC_FILE_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace TokenParser {
+
+#ifdef TOKEN_PARSER_ASYNC_FILE_URING
+
+/// @brief Submission and completion rings of io_uring, set up by the raw
+/// system calls. Only one thread submits and takes the completions.
+struct AsyncFileStreambuf::Ring {
+  Ring();
+  Ring(const Ring& other) = delete;
+  Ring& operator=(const Ring& other) = delete;
+  ~Ring();
+
+  /// @brief Set up a ring of at least entries submissions that reads by
+  /// IORING_OP_READ.
+  /// @return nullptr if io_uring or IORING_OP_READ is unavailable.
+  static std::unique_ptr<Ring> Create(unsigned entries);
+
+  /// @brief Queue the submission, it is submitted by the next Enter().
+  void Push(const io_uring_sqe& sqe);
+
+  /// @brief Submit the queued submissions and wait for min_complete
+  /// completions.
+  /// @return false if the ring fails, interrupted waits are not failures.
+  bool Enter(unsigned min_complete);
+
+  /// @brief Take the next completion.
+  /// @return false if there is no completion.
+  bool Pop(io_uring_cqe& cqe);
+
+  int fd_;
+  unsigned entries_;
+  unsigned to_submit_;
+  void* sq_ptr_;
+  std::size_t sq_size_;
+  void* cq_ptr_;
+  std::size_t cq_size_;
+  void* sqes_ptr_;
+  std::size_t sqes_size_;
+  unsigned* sq_tail_;
+  unsigned sq_mask_;
+  unsigned* sq_array_;
+  io_uring_sqe* sqes_;
+  unsigned* cq_head_;
+  unsigned* cq_tail_;
+  unsigned cq_mask_;
+  io_uring_cqe* cqes_;
+};
+
+AsyncFileStreambuf::Ring::Ring()
+    : fd_(-1),
+      entries_(0),
+      to_submit_(0),
+      sq_ptr_(MAP_FAILED),
+      sq_size_(0),
+      cq_ptr_(MAP_FAILED),
+      cq_size_(0),
+      sqes_ptr_(MAP_FAILED),
+      sqes_size_(0),
+      sq_tail_(nullptr),
+      sq_mask_(0),
+      sq_array_(nullptr),
+      sqes_(nullptr),
+      cq_head_(nullptr),
+      cq_tail_(nullptr),
+      cq_mask_(0),
+      cqes_(nullptr) {}
+
+AsyncFileStreambuf::Ring::~Ring() {
+  if (sqes_ptr_ != MAP_FAILED) ::munmap(sqes_ptr_, sqes_size_);
+  if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_)
+    ::munmap(cq_ptr_, cq_size_);
+  if (sq_ptr_ != MAP_FAILED) ::munmap(sq_ptr_, sq_size_);
+  if (fd_ >= 0) ::close(fd_);
+}
+
+std::unique_ptr<AsyncFileStreambuf::Ring> AsyncFileStreambuf::Ring::Create(
+    unsigned entries) {
+  io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+  if (fd < 0) return nullptr;
+
+  std::unique_ptr<Ring> ring = std::make_unique<Ring>();
+  ring->fd_ = fd;
+  ring->entries_ = params.sq_entries;
+  ring->sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  ring->cq_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap)
+    ring->sq_size_ = ring->cq_size_ = std::max(ring->sq_size_, ring->cq_size_);
+
+  ring->sq_ptr_ = ::mmap(nullptr, ring->sq_size_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (ring->sq_ptr_ == MAP_FAILED) return nullptr;
+  if (single_mmap)
+    ring->cq_ptr_ = ring->sq_ptr_;
+  else
+    ring->cq_ptr_ = ::mmap(nullptr, ring->cq_size_, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+  if (ring->cq_ptr_ == MAP_FAILED) return nullptr;
+  ring->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  ring->sqes_ptr_ = ::mmap(nullptr, ring->sqes_size_, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (ring->sqes_ptr_ == MAP_FAILED) return nullptr;
+
+  char* sq = static_cast<char*>(ring->sq_ptr_);
+  char* cq = static_cast<char*>(ring->cq_ptr_);
+  ring->sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  ring->sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  ring->sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+  ring->sqes_ = static_cast<io_uring_sqe*>(ring->sqes_ptr_);
+  ring->cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  ring->cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  ring->cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  ring->cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+  // IORING_OP_READ is newer than io_uring itself (Linux 5.6).
+  const unsigned kProbeOps = 256;
+  std::vector<char> probe_chars(sizeof(io_uring_probe) +
+                                kProbeOps * sizeof(io_uring_probe_op));
+  io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(probe_chars.data());
+  if (::syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe,
+                kProbeOps) < 0 ||
+      probe->last_op < IORING_OP_READ ||
+      (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) == 0)
+    return nullptr;
+  return ring;
+}
+
+void AsyncFileStreambuf::Ring::Push(const io_uring_sqe& sqe) {
+  // The kernel reads the tail only in io_uring_enter(), no thread polls it.
+  unsigned tail = *sq_tail_;
+  unsigned index = tail & sq_mask_;
+  sqes_[index] = sqe;
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  ++to_submit_;
+}
+
+bool AsyncFileStreambuf::Ring::Enter(unsigned min_complete) {
+  long submitted =
+      ::syscall(__NR_io_uring_enter, fd_, to_submit_, min_complete,
+                min_complete != 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+  if (submitted < 0) return errno == EINTR || errno == EAGAIN;
+  to_submit_ -= static_cast<unsigned>(submitted);
+  return true;
+}
+
+bool AsyncFileStreambuf::Ring::Pop(io_uring_cqe& cqe) {
+  unsigned head = *cq_head_;
+  if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) return false;
+  cqe = cqes_[head & cq_mask_];
+  __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+#else
+
+struct AsyncFileStreambuf::Ring {};
+
+#endif
+
+AsyncFileStreambuf::AsyncFileStreambuf()
+    : fd_(-1),
+      ring_(nullptr),
+      blocks_(std::vector<Block>()),
+      engine_(kEnginePread),
+      direct_io_(false),
+      block_size_(0),
+      file_size_(0),
+      next_offset_(0),
+      head_(0),
+      reading_(false),
+      error_(0) {}
+
+AsyncFileStreambuf::~AsyncFileStreambuf() { Close(); }
+
+bool AsyncFileStreambuf::Open(const std::string& filename,
+                              size_type buff_size, size_type count,
+                              bool direct_io, Engine engine) {
+  Close();
+
+#ifdef TOKEN_PARSER_ASYNC_FILE_POSIX
+  int fd = -1;
+#ifndef O_DIRECT
+  (void)direct_io;
+#else
+  // File systems without direct reads (e.g. tmpfs) refuse O_DIRECT here.
+  if (direct_io) fd = ::open(filename.c_str(), O_RDONLY | O_DIRECT);
+#endif
+  if (fd < 0) fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  return Open(fd, buff_size, count, engine);
+#else
+  (void)filename;
+  (void)buff_size;
+  (void)count;
+  (void)direct_io;
+  (void)engine;
+  return false;
+#endif
+}
+
+bool AsyncFileStreambuf::Open(int fd, size_type buff_size, size_type count,
+                              Engine engine) {
+  Close();
+  error_ = 0;
+
+#ifdef TOKEN_PARSER_ASYNC_FILE_POSIX
+  fd_ = fd;
+  if (fd_ < 0) return false;
+#ifdef O_DIRECT
+  int flags = ::fcntl(fd_, F_GETFL);
+  direct_io_ = flags >= 0 && (flags & O_DIRECT) != 0;
+#endif
+
+  struct stat st;
+  if (::fstat(fd_, &st) != 0 || !S_ISREG(st.st_mode)) {
+    Close();
+    return false;
+  }
+  file_size_ = static_cast<size_type>(st.st_size);
+#ifdef POSIX_FADV_SEQUENTIAL
+  if (!direct_io_) ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+  if (count < kMinCount_) count = kMinCount_;
+  engine_ = kEnginePread;
+#ifdef TOKEN_PARSER_ASYNC_FILE_URING
+  if (engine == kEngineUring) {
+    if (ring_ == nullptr || ring_->entries_ < count)
+      ring_ = Ring::Create(static_cast<unsigned>(count));
+    if (ring_ != nullptr) engine_ = kEngineUring;
+  }
+#else
+  (void)engine;
+#endif
+  // pread() reads only the block the reader needs.
+  if (engine_ == kEnginePread) count = size_type(1);
+
+  if (buff_size == size_type(0)) buff_size = size_type(1);
+  if (direct_io_)
+    buff_size = (buff_size + kDirectAlignment_ - 1) / kDirectAlignment_ *
+                kDirectAlignment_;
+  block_size_ = buff_size;
+  blocks_.resize(count);
+  for (Block& block : blocks_) {
+    block.chars_.resize(buff_size + kDirectAlignment_);
+    std::uintptr_t data =
+        reinterpret_cast<std::uintptr_t>(block.chars_.data());
+    data = (data + kDirectAlignment_ - 1) / kDirectAlignment_ *
+           kDirectAlignment_;
+    block.data_ = reinterpret_cast<char*>(data);
+    block.expected_ = size_type(0);
+    block.pending_ = false;
+  }
+
+  // Some file systems open by O_DIRECT but refuse the reads.
+  if (direct_io_ && file_size_ != size_type(0) &&
+      ::pread(fd_, blocks_[0].data_, kDirectAlignment_, 0) < 0 &&
+      (errno != EINVAL || !DropDirectIo())) {
+    Close();
+    return false;
+  }
+
+  for (size_type slot = 0; slot < blocks_.size(); ++slot) StartBlock(slot);
+  return true;
+#else
+  (void)fd;
+  (void)buff_size;
+  (void)count;
+  (void)engine;
+  return false;
+#endif
+}
+
+void AsyncFileStreambuf::Close() {
+#ifdef TOKEN_PARSER_ASYNC_FILE_URING
+  // The kernel writes to the blocks until the queued reads are complete.
+  if (fd_ >= 0 && engine_ == kEngineUring && ring_ != nullptr) {
+    bool pending = true;
+    while (pending) {
+      pending = false;
+      for (const Block& block : blocks_) pending = pending || block.pending_;
+      // The failed ring is closed, the kernel drops its reads.
+      if (pending && !Reap()) {
+        ring_.reset();
+        break;
+      }
+    }
+  }
+#endif
+  for (Block& block : blocks_) block.pending_ = false;
+#ifdef TOKEN_PARSER_ASYNC_FILE_POSIX
+  if (fd_ >= 0) ::close(fd_);
+#endif
+  fd_ = -1;
+  direct_io_ = false;
+  file_size_ = size_type(0);
+  next_offset_ = size_type(0);
+  head_ = size_type(0);
+  reading_ = false;
+  setg(nullptr, nullptr, nullptr);
+}
+
+bool AsyncFileStreambuf::IsOpen() const { return fd_ >= 0; }
+
+AsyncFileStreambuf::Engine AsyncFileStreambuf::GetEngine() const {
+  return engine_;
+}
+
+bool AsyncFileStreambuf::IsDirectIo() const { return direct_io_; }
+
+int AsyncFileStreambuf::GetError() const { return error_; }
+
+bool AsyncFileStreambuf::IsUringSupported() {
+#ifdef TOKEN_PARSER_ASYNC_FILE_URING
+  static const bool kSupported = Ring::Create(1) != nullptr;
+  return kSupported;
+#else
+  return false;
+#endif
+}
+
+AsyncFileStreambuf::int_type AsyncFileStreambuf::underflow() {
+  if (fd_ < 0) return traits_type::eof();
+
+  if (reading_) {
+    // The taken block reads the block after the queued ones.
+    reading_ = false;
+    blocks_[head_].expected_ = size_type(0);
+    StartBlock(head_);
+    head_ = (head_ + 1) % blocks_.size();
+  }
+
+  Block& block = blocks_[head_];
+  if (block.expected_ == size_type(0)) {
+    setg(nullptr, nullptr, nullptr);
+    return traits_type::eof();
+  }
+
+  bool read = engine_ == kEngineUring ? WaitBlock(head_) : ReadBlock(head_);
+  if (!read) {
+    // The stream goes bad as std::filebuf makes it on a read error, not
+    // eof, so a truncated input is not taken for the whole file.
+    error_ = block.error_ != 0 ? block.error_ : EIO;
+    Close();
+    throw std::ios_base::failure(
+        "AsyncFileStreambuf: read failed",
+        std::error_code(error_, std::generic_category()));
+  }
+  if (block.size_ == size_type(0)) {
+    Close();
+    return traits_type::eof();
+  }
+
+  reading_ = true;
+  setg(block.data_, block.data_, block.data_ + block.size_);
+  return traits_type::to_int_type(*block.data_);
+}
+
+bool AsyncFileStreambuf::StartBlock(size_type slot) {
+  if (next_offset_ >= file_size_) return false;
+
+  Block& block = blocks_[slot];
+  block.offset_ = next_offset_;
+  block.size_ = size_type(0);
+  block.expected_ = std::min(block_size_, file_size_ - next_offset_);
+  block.pending_ = false;
+  block.error_ = 0;
+  next_offset_ += block.expected_;
+  if (engine_ == kEngineUring) QueueRead(slot);
+  return true;
+}
+
+void AsyncFileStreambuf::QueueRead(size_type slot) {
+#ifdef TOKEN_PARSER_ASYNC_FILE_URING
+  // Direct reads take whole aligned blocks, the last one ends at the file
+  // end.
+  Block& block = blocks_[slot];
+  size_type size = (direct_io_ ? block_size_ : block.expected_) - block.size_;
+  io_uring_sqe sqe;
+  std::memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = IORING_OP_READ;
+  sqe.fd = fd_;
+  sqe.off = block.offset_ + block.size_;
+  sqe.addr = reinterpret_cast<std::uint64_t>(block.data_ + block.size_);
+  sqe.len = static_cast<std::uint32_t>(size);
+  sqe.user_data = slot;
+  ring_->Push(sqe);
+  block.pending_ = true;
+#else
+  (void)slot;
+#endif
+}
+
+bool AsyncFileStreambuf::WaitBlock(size_type slot) {
+  Block& block = blocks_[slot];
+  while (true) {
+    if (block.error_ != 0) return false;
+    if (!block.pending_) {
+      if (block.size_ >= block.expected_) return true;
+      QueueRead(slot);
+    }
+    if (!Reap()) return false;
+  }
+}
+
+bool AsyncFileStreambuf::Reap() {
+#ifdef TOKEN_PARSER_ASYNC_FILE_URING
+  if (!ring_->Enter(1)) return false;
+
+  io_uring_cqe cqe;
+  while (ring_->Pop(cqe)) {
+    Block& block = blocks_[static_cast<size_type>(cqe.user_data)];
+    block.pending_ = false;
+    if (cqe.res > 0)
+      block.size_ = std::min(block.size_ + static_cast<size_type>(cqe.res),
+                             block.expected_);
+    else if (cqe.res == 0)
+      block.expected_ = block.size_;
+    else if (cqe.res != -EINTR && cqe.res != -EAGAIN)
+      block.error_ = -cqe.res;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool AsyncFileStreambuf::ReadBlock(size_type slot) {
+#ifdef TOKEN_PARSER_ASYNC_FILE_POSIX
+  Block& block = blocks_[slot];
+  while (block.size_ < block.expected_) {
+    size_type size =
+        (direct_io_ ? block_size_ : block.expected_) - block.size_;
+    ssize_t n = ::pread(fd_, block.data_ + block.size_, size,
+                        static_cast<off_t>(block.offset_ + block.size_));
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      block.error_ = errno;
+      return false;
+    }
+    if (n == 0) {
+      block.expected_ = block.size_;
+      break;
+    }
+    block.size_ =
+        std::min(block.size_ + static_cast<size_type>(n), block.expected_);
+  }
+  return true;
+#else
+  (void)slot;
+  return false;
+#endif
+}
+
+bool AsyncFileStreambuf::DropDirectIo() {
+#if defined(TOKEN_PARSER_ASYNC_FILE_POSIX) && defined(O_DIRECT)
+  int flags = ::fcntl(fd_, F_GETFL);
+  if (flags < 0 || ::fcntl(fd_, F_SETFL, flags & ~O_DIRECT) != 0)
+    return false;
+  direct_io_ = false;
+  return true;
+#else
+  return false;
+#endif
+}
+
+const AsyncFileStreambuf::size_type AsyncFileStreambuf::kMinCount_ = 2;
+const AsyncFileStreambuf::size_type AsyncFileStreambuf::kDirectAlignment_ =
+    4096;
+
+}  // namespace TokenParser
@@ -0,0 +1,150 @@
+#include "../include/token_parser/char_set.h"
+
+#include <string>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TOKEN_PARSER_CHAR_SET_X86
+#include <immintrin.h>
+#endif
+
+namespace TokenParser {
+
+namespace {
+
+const char* FindScalar(const std::array<bool, 256>& table, bool in_set,
+                       const char* first, const char* last) {
+  while (first != last && table[static_cast<unsigned char>(*first)] != in_set)
+    ++first;
+  return first;
+}
+
+#ifdef TOKEN_PARSER_CHAR_SET_X86
+
+__attribute__((target("sse2"))) const char* FindSse2(
+    const std::array<bool, 256>& table, const std::string& chars, bool in_set,
+    const char* first, const char* last) {
+  const unsigned kFlip = in_set ? 0u : 0xffffu;
+  __m128i set[CharSet::kMaxVectorChars];
+  std::string::size_type nchars = chars.size();
+  if (nchars > CharSet::kMaxVectorChars) nchars = CharSet::kMaxVectorChars;
+  for (std::string::size_type k = 0; k < nchars; ++k)
+    set[k] = _mm_set1_epi8(chars[k]);
+
+  // Sets bigger than kMaxVectorChars are searched by the scalar loop.
+  const bool full = nchars == chars.size();
+  while (full && last - first >= 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    __m128i eq = _mm_setzero_si128();
+    for (std::string::size_type k = 0; k < nchars; ++k)
+      eq = _mm_or_si128(eq, _mm_cmpeq_epi8(v, set[k]));
+
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(eq)) ^ kFlip;
+    if (mask != 0u) return first + __builtin_ctz(mask);
+    first += 16;
+  }
+
+  return FindScalar(table, in_set, first, last);
+}
+
+__attribute__((target("avx2"))) const char* FindAvx2(
+    const std::array<bool, 256>& table, const std::string& chars, bool in_set,
+    const char* first, const char* last) {
+  const unsigned kFlip = in_set ? 0u : 0xffffffffu;
+  __m256i set[CharSet::kMaxVectorChars];
+  std::string::size_type nchars = chars.size();
+  if (nchars > CharSet::kMaxVectorChars) nchars = CharSet::kMaxVectorChars;
+  for (std::string::size_type k = 0; k < nchars; ++k)
+    set[k] = _mm256_set1_epi8(chars[k]);
+
+  const bool full = nchars == chars.size();
+  while (full && last - first >= 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    __m256i eq = _mm256_setzero_si256();
+    for (std::string::size_type k = 0; k < nchars; ++k)
+      eq = _mm256_or_si256(eq, _mm256_cmpeq_epi8(v, set[k]));
+
+    unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(eq)) ^ kFlip;
+    if (mask != 0u) return first + __builtin_ctz(mask);
+    first += 32;
+  }
+
+  return FindSse2(table, chars, in_set, first, last);
+}
+
+#endif  // TOKEN_PARSER_CHAR_SET_X86
+
+}  // namespace
+
+CharSet::CharSet() : CharSet(std::string()) {}
+
+CharSet::CharSet(const std::string& chars) { Assign(chars); }
+
+CharSet::~CharSet() {}
+
+void CharSet::Assign(const std::string& chars) {
+  table_.fill(false);
+  chars_.clear();
+  for (char ch : chars) {
+    if (table_[static_cast<unsigned char>(ch)]) continue;
+    table_[static_cast<unsigned char>(ch)] = true;
+    chars_.push_back(ch);
+  }
+
+  kernel_ = kKernelScalar;
+  if (chars_.size() > kMaxVectorChars) return;
+  if (IsKernelSupported(kKernelAvx2))
+    kernel_ = kKernelAvx2;
+  else if (IsKernelSupported(kKernelSse2))
+    kernel_ = kKernelSse2;
+}
+
+CharSet::Kernel CharSet::GetKernel() const { return kernel_; }
+
+const char* CharSet::Find(const char* first, const char* last,
+                          Kernel kernel) const {
+  return FindByKernel(first, last, true, kernel);
+}
+
+const char* CharSet::FindNot(const char* first, const char* last,
+                             Kernel kernel) const {
+  return FindByKernel(first, last, false, kernel);
+}
+
+bool CharSet::IsKernelSupported(Kernel kernel) {
+  switch (kernel) {
+    case kKernelScalar:
+      return true;
+#ifdef TOKEN_PARSER_CHAR_SET_X86
+    case kKernelSse2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse2");
+    case kKernelAvx2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2");
+#endif
+    default:
+      break;
+  }
+  return false;
+}
+
+const char* CharSet::FindByKernel(const char* first, const char* last,
+                                  bool in_set, Kernel kernel) const {
+  if (!in_set && chars_.empty()) return first;
+  if (in_set && chars_.empty()) return last;
+
+  switch (kernel) {
+#ifdef TOKEN_PARSER_CHAR_SET_X86
+    case kKernelSse2:
+      return FindSse2(table_, chars_, in_set, first, last);
+    case kKernelAvx2:
+      return FindAvx2(table_, chars_, in_set, first, last);
+#endif
+    default:
+      break;
+  }
+
+  return FindScalar(table_, in_set, first, last);
+}
+
+}  // namespace TokenParser
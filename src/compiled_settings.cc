@@ -0,0 +1,60 @@
+#include "../include/token_parser/compiled_settings.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "../include/token_parser/settings.h"
+
+namespace TokenParser {
+
+CompiledSettings::CompiledSettings() : CompiledSettings(Settings()) {}
+
+CompiledSettings::CompiledSettings(const Settings& settings)
+    : settings_(settings), id_is_word_(false) {
+  Build();
+}
+
+CompiledSettings::CompiledSettings(Settings&& settings)
+    : settings_(std::move(settings)), id_is_word_(false) {
+  Build();
+}
+
+CompiledSettings::~CompiledSettings() {}
+
+CompiledSettings::Ptr CompiledSettings::Compile(const Settings& settings) {
+  return std::make_shared<CompiledSettings>(settings);
+}
+
+CompiledSettings::Ptr CompiledSettings::Compile(Settings&& settings) {
+  return std::make_shared<CompiledSettings>(std::move(settings));
+}
+
+const CompiledSettings::Ptr& CompiledSettings::GetDefault() {
+  static const Ptr kDefault = Compile(Settings());
+  return kDefault;
+}
+
+const Settings& CompiledSettings::GetSettings() const { return settings_; }
+
+bool CompiledSettings::GetIdIsWord() const { return id_is_word_; }
+
+void CompiledSettings::Build() {
+  settings_.GetKeywordTrie();
+  const Settings::CharClasses& char_classes = settings_.GetCharClasses();
+
+  // An id that starts with a word delim char is never found at a word.
+  auto is_delim = [&char_classes](char ch) {
+    return char_classes[static_cast<unsigned char>(ch)] &
+           Settings::kCharClassWordDelim;
+  };
+  id_is_word_ = true;
+  for (const auto& token_id : settings_.GetTokenIds()) {
+    const std::string& text = token_id.second;
+    if (text.empty() || is_delim(text[0])) continue;
+    for (char ch : text)
+      if (is_delim(ch)) id_is_word_ = false;
+  }
+}
+
+}  // namespace TokenParser
@@ -2,16 +2,28 @@
 #include "../include/token_parser/file_parser.h"
 
 #include <fstream>
+#include <ios>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
+#include "../include/token_parser/async_file_streambuf.h"
+#include "../include/token_parser/compiled_settings.h"
+#include "../include/token_parser/lexeme.h"
+#include "../include/token_parser/mapped_file.h"
+#include "../include/token_parser/position.h"
+#include "../include/token_parser/read_ahead_streambuf.h"
 #include "../include/token_parser/settings.h"
 #include "../include/token_parser/stream_parser.h"
 #include "../include/token_parser/token.h"
+#include "../include/token_parser/token_buffer.h"
 
 namespace TokenParser {
 
-FileParser::FileParser() : FileParser(Settings(), std::string()) {}
+FileParser::FileParser()
+    : FileParser(CompiledSettings::GetDefault(), std::string()) {}
 
 FileParser::FileParser(const Settings& settings)
     : FileParser(settings, std::string()) {}
@@ -20,22 +32,82 @@ FileParser::FileParser(Settings&& settings)
     : FileParser(std::move(settings), std::string()) {}
 
 FileParser::FileParser(const std::string& filename)
-    : FileParser(Settings(), filename) {}
+    : FileParser(CompiledSettings::GetDefault(), filename) {}
+
+FileParser::FileParser(CompiledSettings::Ptr settings)
+    : FileParser(std::move(settings), std::string()) {}
 
 FileParser::FileParser(const Settings& settings, const std::string& filename)
-    : stream_parser_(settings), file_(std::ifstream()) {
+    : stream_parser_(settings),
+      file_buff_(std::vector<char>(kFileBuffSize_)),
+      file_(std::ifstream()),
+      mapped_file_(MappedFile()),
+      backend_(kDefaultBackend_),
+      read_ahead_(nullptr),
+      read_ahead_count_(kDefaultReadAheadCount_),
+      async_(nullptr),
+      direct_io_(false) {
   SetFile(filename);
 }
 
 FileParser::FileParser(Settings&& settings, const std::string& filename)
-    : stream_parser_(std::move(settings)), file_(std::ifstream()) {
+    : stream_parser_(std::move(settings)),
+      file_buff_(std::vector<char>(kFileBuffSize_)),
+      file_(std::ifstream()),
+      mapped_file_(MappedFile()),
+      backend_(kDefaultBackend_),
+      read_ahead_(nullptr),
+      read_ahead_count_(kDefaultReadAheadCount_),
+      async_(nullptr),
+      direct_io_(false) {
+  SetFile(filename);
+}
+
+FileParser::FileParser(CompiledSettings::Ptr settings,
+                       const std::string& filename)
+    : stream_parser_(std::move(settings)),
+      file_buff_(std::vector<char>(kFileBuffSize_)),
+      file_(std::ifstream()),
+      mapped_file_(MappedFile()),
+      backend_(kDefaultBackend_),
+      read_ahead_(nullptr),
+      read_ahead_count_(kDefaultReadAheadCount_),
+      async_(nullptr),
+      direct_io_(false) {
   SetFile(filename);
 }
 
 FileParser::~FileParser() {}
 
+FileParser::ReadAhead::ReadAhead()
+    : file_(),
+      buff_(),
+      stream_(&buff_) {}
+
+FileParser::Async::Async() : buff_(), stream_(&buff_) {}
+
 void FileParser::SetFile(const std::string& filename) {
   file_.close();
+  file_.clear();
+  mapped_file_.Close();
+  CloseReadAhead();
+  CloseAsync();
+
+  if (backend_ == kBackendMmap && mapped_file_.Open(filename)) {
+    stream_parser_.SetBuffer(mapped_file_.GetView());
+    return;
+  }
+
+  if (backend_ == kBackendReadAhead) {
+    OpenReadAhead(filename);
+    return;
+  }
+
+  if (backend_ == kBackendAsync && OpenAsync(filename)) return;
+
+  // The file buffer is owned by the parser, so reopening does not allocate.
+  file_.rdbuf()->pubsetbuf(file_buff_.data(),
+                           static_cast<std::streamsize>(file_buff_.size()));
   file_.open(filename);
   if (file_.fail())
     stream_parser_.SetStream(nullptr);
@@ -43,6 +115,29 @@ void FileParser::SetFile(const std::string& filename) {
     stream_parser_.SetStream(&file_);
 }
 
+void FileParser::Reset() {
+  file_.close();
+  file_.clear();
+  mapped_file_.Close();
+  CloseReadAhead();
+  CloseAsync();
+  stream_parser_.Reset();
+}
+
+void FileParser::ShrinkToFit() { stream_parser_.ShrinkToFit(); }
+
+void FileParser::SetBackend(Backend backend) { backend_ = backend; }
+
+void FileParser::SetBuffSize(size_type buff_size) {
+  stream_parser_.SetBuffSize(buff_size);
+}
+
+void FileParser::SetReadAheadCount(size_type count) {
+  read_ahead_count_ = count;
+}
+
+void FileParser::SetDirectIo(bool direct_io) { direct_io_ = direct_io; }
+
 void FileParser::SetSettings(const Settings& settings) {
   stream_parser_.SetSettings(settings);
 }
@@ -51,22 +146,68 @@ void FileParser::SetSettings(Settings&& settings) {
   stream_parser_.SetSettings(std::move(settings));
 }
 
+void FileParser::SetSettings(CompiledSettings::Ptr settings) {
+  stream_parser_.SetSettings(std::move(settings));
+}
+
 const std::string* FileParser::GetStr() const {
   return stream_parser_.GetStr();
 }
 
+std::string_view FileParser::GetView() const {
+  return stream_parser_.GetView();
+}
+
 FileParser::size_type FileParser::GetI() const { return stream_parser_.GetI(); }
 
+FileParser::Backend FileParser::GetBackend() const { return backend_; }
+
+FileParser::size_type FileParser::GetBuffSize() const {
+  return stream_parser_.GetBuffSize();
+}
+
+FileParser::size_type FileParser::GetViewOffset() const {
+  return stream_parser_.GetViewOffset();
+}
+
+FileParser::size_type FileParser::GetReadAheadCount() const {
+  return read_ahead_count_;
+}
+
+bool FileParser::GetDirectIo() const { return direct_io_; }
+
+bool FileParser::IsMapped() const { return mapped_file_.IsOpen(); }
+
+bool FileParser::HasReadError() const {
+  if (file_.bad()) return true;
+  if (read_ahead_ != nullptr && read_ahead_->stream_.bad()) return true;
+  return async_ != nullptr && async_->stream_.bad();
+}
+
 const Settings& FileParser::GetSettings() const {
   return stream_parser_.GetSettings();
 }
 
-Settings& FileParser::GetSettings() { return stream_parser_.GetSettings(); }
+const CompiledSettings::Ptr& FileParser::GetCompiledSettings() const {
+  return stream_parser_.GetCompiledSettings();
+}
+
+Position FileParser::GetPosition() const {
+  return stream_parser_.GetPosition();
+}
+
+Position FileParser::GetPosition(size_type i) const {
+  return stream_parser_.GetPosition(i);
+}
 
 bool FileParser::IsEnd() const { return stream_parser_.IsEnd(); }
 
 std::string FileParser::NextWord() { return stream_parser_.NextWord(); }
 
+std::string_view FileParser::NextWordView() {
+  return stream_parser_.NextWordView();
+}
+
 Token FileParser::NextInt() { return stream_parser_.NextInt(); }
 
 Token FileParser::NextUint() { return stream_parser_.NextUint(); }
@@ -79,4 +220,72 @@ Token FileParser::NextThisId(Token::id_type id) {
   return stream_parser_.NextThisId(id);
 }
 
+Lexeme FileParser::NextAny() { return stream_parser_.NextAny(); }
+
+FileParser::size_type FileParser::NextBatch(Lexeme* lexemes,
+                                            size_type count) {
+  return stream_parser_.NextBatch(lexemes, count);
+}
+
+FileParser::size_type FileParser::NextBatch(TokenBuffer& buffer,
+                                            size_type count) {
+  return stream_parser_.NextBatch(buffer, count);
+}
+
+Token FileParser::PeekId() { return stream_parser_.PeekId(); }
+
+std::string FileParser::PeekWord() { return stream_parser_.PeekWord(); }
+
+std::string_view FileParser::PeekWordView() {
+  return stream_parser_.PeekWordView();
+}
+
+Lexeme FileParser::PeekAny() { return stream_parser_.PeekAny(); }
+
+void FileParser::OpenReadAhead(const std::string& filename) {
+  if (read_ahead_ == nullptr) read_ahead_ = std::make_unique<ReadAhead>();
+
+  if (read_ahead_->file_.open(filename, std::ios_base::in) == nullptr) {
+    stream_parser_.SetStream(nullptr);
+    return;
+  }
+
+  read_ahead_->buff_.Open(&read_ahead_->file_, GetBuffSize(),
+                          read_ahead_count_);
+  read_ahead_->stream_.clear();
+  stream_parser_.SetStream(&read_ahead_->stream_);
+}
+
+void FileParser::CloseReadAhead() {
+  if (read_ahead_ == nullptr) return;
+
+  // The thread reads the file until it is stopped.
+  read_ahead_->buff_.Close();
+  read_ahead_->file_.close();
+  read_ahead_->stream_.clear();
+}
+
+void FileParser::CloseAsync() {
+  if (async_ == nullptr) return;
+
+  async_->buff_.Close();
+  async_->stream_.clear();
+}
+
+bool FileParser::OpenAsync(const std::string& filename) {
+  if (async_ == nullptr) async_ = std::make_unique<Async>();
+
+  if (!async_->buff_.Open(filename, GetBuffSize(), read_ahead_count_,
+                          direct_io_))
+    return false;
+
+  async_->stream_.clear();
+  stream_parser_.SetStream(&async_->stream_);
+  return true;
+}
+
+const FileParser::Backend FileParser::kDefaultBackend_ = kBackendStream;
+const FileParser::size_type FileParser::kFileBuffSize_ = 1 << 13;
+const FileParser::size_type FileParser::kDefaultReadAheadCount_ = 4;
+
 }  // namespace TokenParser
@@ -0,0 +1,56 @@
+#include "../include/token_parser/id_index.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace TokenParser {
+
+IdIndex::IdIndex() : dense_(false) {}
+
+IdIndex::IdIndex(const TokenIds& token_ids) : dense_(false) {
+  Build(token_ids);
+}
+
+IdIndex::~IdIndex() {}
+
+void IdIndex::Build(const TokenIds& token_ids) {
+  entries_.clear();
+  texts_.clear();
+  dense_ = false;
+  if (token_ids.empty()) return;
+
+  // token_ids is ordered by id, so the first id is the smallest one and the
+  // last id is the biggest one.
+  id_type min_id = token_ids.begin()->first;
+  id_type max_id = token_ids.rbegin()->first;
+  dense_ = min_id >= 0 && static_cast<size_type>(max_id) <
+                              kDenseFactor * token_ids.size() + kDenseSlack;
+
+  size_type texts_size = 0;
+  for (const auto& token_id : token_ids) texts_size += token_id.second.size();
+  texts_.reserve(texts_size);
+
+  if (dense_)
+    entries_.assign(static_cast<size_type>(max_id) + 1,
+                    Entry{id_type(0), 0, 0, false});
+  else
+    entries_.reserve(token_ids.size());
+
+  for (const auto& token_id : token_ids) {
+    Entry entry{token_id.first, static_cast<uint32_t>(texts_.size()),
+                static_cast<uint32_t>(token_id.second.size()), true};
+    texts_ += token_id.second;
+    if (dense_)
+      entries_[static_cast<size_type>(token_id.first)] = entry;
+    else
+      entries_.push_back(entry);
+  }
+}
+
+bool IdIndex::Empty() const { return entries_.empty(); }
+
+bool IdIndex::IsDense() const { return dense_; }
+
+}  // namespace TokenParser
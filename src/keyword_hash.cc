@@ -0,0 +1,49 @@
+#include "../include/token_parser/keyword_hash.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TokenParser {
+
+KeywordHash::KeywordHash() : mask_(0) {}
+
+KeywordHash::KeywordHash(const TokenIds& token_ids) : mask_(0) {
+  Build(token_ids);
+}
+
+KeywordHash::~KeywordHash() {}
+
+void KeywordHash::Build(const TokenIds& token_ids) {
+  slots_.clear();
+  texts_.clear();
+  mask_ = 0;
+  if (token_ids.empty()) return;
+
+  std::size_t capacity = 2;
+  while (capacity < 2 * token_ids.size()) capacity *= 2;
+  slots_.assign(capacity, Slot{0, 0, 0, id_type(0), false});
+  mask_ = capacity - 1;
+
+  // token_ids is ordered by id, so the first id with a text is the smallest
+  // one and the next ones are skipped.
+  for (const auto& token_id : token_ids) {
+    id_type id;
+    if (Find(token_id.second, id)) continue;
+
+    std::size_t hash = Hash(token_id.second);
+    std::size_t k = hash & mask_;
+    while (slots_[k].used_) k = (k + 1) & mask_;
+    slots_[k] = Slot{hash, static_cast<uint32_t>(texts_.size()),
+                     static_cast<uint32_t>(token_id.second.length()),
+                     token_id.first, true};
+    texts_ += token_id.second;
+  }
+}
+
+bool KeywordHash::Empty() const { return slots_.empty(); }
+
+}  // namespace TokenParser
@@ -0,0 +1,82 @@
+#include "../include/token_parser/keyword_trie.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace TokenParser {
+
+KeywordTrie::KeywordTrie() : max_length_(0) {}
+
+KeywordTrie::KeywordTrie(const TokenIds& token_ids) : max_length_(0) {
+  Build(token_ids);
+}
+
+KeywordTrie::~KeywordTrie() {}
+
+void KeywordTrie::Build(const TokenIds& token_ids) {
+  nodes_.clear();
+  edge_chars_.clear();
+  edge_nodes_.clear();
+  max_length_ = 0;
+  if (token_ids.empty()) return;
+
+  std::vector<std::map<unsigned char, uint32_t>> children(1);
+  nodes_.push_back(Node{0, 0, id_type(0), false});
+
+  for (const auto& token_id : token_ids) {
+    max_length_ = std::max(max_length_, token_id.second.length());
+    uint32_t node = 0;
+    for (char ch : token_id.second) {
+      unsigned char uch = static_cast<unsigned char>(ch);
+      auto iter = children[node].find(uch);
+      if (iter != children[node].end()) {
+        node = iter->second;
+        continue;
+      }
+
+      uint32_t child = static_cast<uint32_t>(nodes_.size());
+      children[node].insert({uch, child});
+      children.emplace_back();
+      nodes_.push_back(Node{0, 0, id_type(0), false});
+      node = child;
+    }
+
+    // token_ids is ordered by id, so the first id with this text is the
+    // smallest one.
+    if (!nodes_[node].has_id_) {
+      nodes_[node].has_id_ = true;
+      nodes_[node].id_ = token_id.first;
+    }
+  }
+
+  for (uint32_t node = 0; node < nodes_.size(); ++node) {
+    nodes_[node].edges_begin_ = static_cast<uint32_t>(edge_chars_.size());
+    for (auto child : children[node]) {
+      edge_chars_.push_back(child.first);
+      edge_nodes_.push_back(child.second);
+    }
+    nodes_[node].edges_end_ = static_cast<uint32_t>(edge_chars_.size());
+  }
+}
+
+bool KeywordTrie::Empty() const { return nodes_.empty(); }
+
+bool KeywordTrie::IsProperPrefix(const char* first, const char* last) const {
+  if (nodes_.empty()) return false;
+
+  uint32_t node = 0;
+  for (; first != last; ++first) {
+    node = Child(node, *first);
+    if (node == kNoNode_) return false;
+  }
+  return nodes_[node].edges_begin_ != nodes_[node].edges_end_;
+}
+
+KeywordTrie::size_type KeywordTrie::GetMaxLength() const {
+  return max_length_;
+}
+
+}  // namespace TokenParser
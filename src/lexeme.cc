@@ -0,0 +1,38 @@
+#include "../include/token_parser/lexeme.h"
+
+#include <string_view>
+
+#include "../include/token_parser/token.h"
+
+namespace TokenParser {
+
+Lexeme::Lexeme() : Lexeme(Token(), std::string_view(), size_type(0)) {}
+
+Lexeme::Lexeme(const Token& token, std::string_view text, size_type start)
+    : token_(token), text_(text), start_(start) {}
+
+Lexeme::Lexeme(std::string_view word, size_type start)
+    : Lexeme(Token(), word, start) {}
+
+bool Lexeme::operator==(const Lexeme& other) const {
+  return token_ == other.token_ && text_ == other.text_ &&
+         start_ == other.start_;
+}
+
+bool Lexeme::operator!=(const Lexeme& other) const {
+  return !this->operator==(other);
+}
+
+const Token& Lexeme::GetToken() const { return token_; }
+
+std::string_view Lexeme::GetText() const { return text_; }
+
+Lexeme::size_type Lexeme::GetStart() const { return start_; }
+
+bool Lexeme::IsToken() const { return !token_.IsNull(); }
+
+bool Lexeme::IsWord() const { return token_.IsNull() && !text_.empty(); }
+
+bool Lexeme::IsEnd() const { return token_.IsNull() && text_.empty(); }
+
+}  // namespace TokenParser
@@ -0,0 +1,251 @@
+#include "../include/token_parser/line_counter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+
+#include "../include/token_parser/char_set.h"
+#include "../include/token_parser/position.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TOKEN_PARSER_LINE_COUNTER_X86
+#include <immintrin.h>
+#endif
+
+namespace TokenParser {
+
+namespace {
+
+using size_type = LineCounter::size_type;
+
+size_type CountScalar(const char* first, const char* last,
+                      const char*& last_newline) {
+  size_type count = 0;
+  for (; first != last; ++first) {
+    if (*first != '\n') continue;
+    ++count;
+    last_newline = first;
+  }
+  return count;
+}
+
+#ifdef TOKEN_PARSER_LINE_COUNTER_X86
+
+// SSE2 CPUs may have no POPCNT, __builtin_popcount() is generic code here.
+__attribute__((target("sse2"))) size_type CountSse2(
+    const char* first, const char* last, const char*& last_newline) {
+  const __m128i kNewline = _mm_set1_epi8('\n');
+  size_type count = 0;
+  while (last - first >= 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    unsigned mask =
+        static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, kNewline)));
+    if (mask != 0u) {
+      count += static_cast<size_type>(__builtin_popcount(mask));
+      last_newline = first + (31 - __builtin_clz(mask));
+    }
+    first += 16;
+  }
+
+  return count + CountScalar(first, last, last_newline);
+}
+
+// GCC enables POPCNT with AVX2, see LineCounter::IsKernelSupported().
+__attribute__((target("avx2,popcnt"))) size_type CountAvx2(
+    const char* first, const char* last, const char*& last_newline) {
+  const __m256i kNewline = _mm256_set1_epi8('\n');
+  size_type count = 0;
+  while (last - first >= 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    unsigned mask = static_cast<unsigned>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, kNewline)));
+    if (mask != 0u) {
+      count += static_cast<size_type>(__builtin_popcount(mask));
+      last_newline = first + (31 - __builtin_clz(mask));
+    }
+    first += 32;
+  }
+
+  return count + CountSse2(first, last, last_newline);
+}
+
+__attribute__((target("sse2"))) uint64_t MaskSse2(const char* first) {
+  const __m128i kNewline = _mm_set1_epi8('\n');
+  uint64_t mask = 0;
+  for (int k = 0; k < 4; ++k) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    uint64_t bits = static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(v, kNewline)));
+    mask |= bits << (16 * k);
+    first += 16;
+  }
+  return mask;
+}
+
+#endif  // TOKEN_PARSER_LINE_COUNTER_X86
+
+/// @brief Bit k is set if first[k] is '\n', at most 64 chars.
+uint64_t NewlineMask(const char* first, const char* last,
+                     CharSet::Kernel kernel) {
+#ifdef TOKEN_PARSER_LINE_COUNTER_X86
+  if (last - first == 64 && kernel != CharSet::kKernelScalar)
+    return MaskSse2(first);
+#else
+  (void)kernel;
+#endif
+  uint64_t mask = 0;
+  for (const char* i = first; i != last; ++i)
+    if (*i == '\n') mask |= uint64_t(1) << (i - first);
+  return mask;
+}
+
+CharSet::Kernel BestKernel() {
+  if (LineCounter::IsKernelSupported(CharSet::kKernelAvx2))
+    return CharSet::kKernelAvx2;
+  if (LineCounter::IsKernelSupported(CharSet::kKernelSse2))
+    return CharSet::kKernelSse2;
+  return CharSet::kKernelScalar;
+}
+
+CharSet::Kernel DefaultKernel() {
+  static const CharSet::Kernel kernel = BestKernel();
+  return kernel;
+}
+
+}  // namespace
+
+LineCounter::LineCounter() { Reset(); }
+
+LineCounter::~LineCounter() {}
+
+void LineCounter::Reset(const Position& base) {
+  base_ = base;
+  i_ = size_type(0);
+  line_ = base.GetLine();
+  line_offset_ = base.GetOffset() - (base.GetColumn() - 1);
+  mask_ = 0;
+  mask_end_ = size_type(0);
+}
+
+const Position& LineCounter::GetBase() const { return base_; }
+
+Position LineCounter::PositionAt(std::string_view str, size_type i) {
+  if (i > str.length()) i = str.length();
+  if (i < i_) Reset(base_);
+
+  if (i > mask_end_) {
+    // The jump is counted by the kernel, the next chars are taken as a mask.
+    const char* last_newline = nullptr;
+    line_ += CountNewlines(str.data() + i_, str.data() + i, last_newline);
+    if (last_newline != nullptr)
+      line_offset_ = base_.GetOffset() + (last_newline - str.data()) + 1;
+    i_ = i;
+    mask_end_ = std::min(i + 64, str.length());
+    mask_ = NewlineMask(str.data() + i, str.data() + mask_end_,
+                        DefaultKernel());
+  }
+
+  size_type step = i - i_;
+  if (step != size_type(0)) {
+    uint64_t bits = step == 64 ? mask_ : mask_ & ((uint64_t(1) << step) - 1);
+    if (bits != 0) {
+      line_offset_ = base_.GetOffset() + i_ + (64 - __builtin_clzll(bits));
+      for (; bits != 0; bits &= bits - 1) ++line_;
+    }
+    mask_ = step == 64 ? 0 : mask_ >> step;
+    i_ = i;
+  }
+
+  size_type offset = base_.GetOffset() + i;
+  return Position(offset, line_, offset - line_offset_ + 1);
+}
+
+void LineCounter::PositionsAt(std::string_view str, const size_type* offsets,
+                              size_type count, size_type* lines,
+                              size_type* columns) {
+  // The state is kept in locals, the stores to the arrays may alias it.
+  const size_type base = base_.GetOffset();
+  const char* data = str.data();
+  size_type length = str.length();
+  size_type i_prev = i_;
+  size_type line = line_;
+  size_type line_offset = line_offset_;
+  uint64_t mask = mask_;
+  size_type mask_end = mask_end_;
+
+  for (size_type k = 0; k < count; ++k) {
+    size_type i = std::min(offsets[k] - base, length);
+    if (i < i_prev) {
+      Reset(base_);
+      i_prev = i_;
+      line = line_;
+      line_offset = line_offset_;
+      mask = mask_;
+      mask_end = mask_end_;
+    }
+
+    if (i > mask_end) {
+      const char* last_newline = nullptr;
+      line += CountNewlines(data + i_prev, data + i, last_newline);
+      if (last_newline != nullptr)
+        line_offset = base + (last_newline - data) + 1;
+      i_prev = i;
+      mask_end = std::min(i + 64, length);
+      mask = NewlineMask(data + i, data + mask_end, DefaultKernel());
+    }
+
+    size_type step = i - i_prev;
+    if (step != size_type(0)) {
+      uint64_t bits = step == 64 ? mask : mask & ((uint64_t(1) << step) - 1);
+      if (bits != 0) {
+        line_offset = base + i_prev + (64 - __builtin_clzll(bits));
+        for (; bits != 0; bits &= bits - 1) ++line;
+      }
+      mask = step == 64 ? 0 : mask >> step;
+      i_prev = i;
+    }
+
+    lines[k] = line;
+    columns[k] = base + i - line_offset + 1;
+  }
+
+  i_ = i_prev;
+  line_ = line;
+  line_offset_ = line_offset;
+  mask_ = mask;
+  mask_end_ = mask_end;
+}
+
+LineCounter::size_type LineCounter::CountNewlines(const char* first,
+                                                  const char* last,
+                                                  const char*& last_newline) {
+  return CountNewlines(first, last, last_newline, DefaultKernel());
+}
+
+bool LineCounter::IsKernelSupported(CharSet::Kernel kernel) {
+  if (!CharSet::IsKernelSupported(kernel)) return false;
+#ifdef TOKEN_PARSER_LINE_COUNTER_X86
+  if (kernel == CharSet::kKernelAvx2) return __builtin_cpu_supports("popcnt");
+#endif
+  return true;
+}
+
+LineCounter::size_type LineCounter::CountNewlines(const char* first,
+                                                  const char* last,
+                                                  const char*& last_newline,
+                                                  CharSet::Kernel kernel) {
+  switch (kernel) {
+#ifdef TOKEN_PARSER_LINE_COUNTER_X86
+    case CharSet::kKernelSse2:
+      return CountSse2(first, last, last_newline);
+    case CharSet::kKernelAvx2:
+      return CountAvx2(first, last, last_newline);
+#endif
+    default:
+      break;
+  }
+
+  return CountScalar(first, last, last_newline);
+}
+
+}  // namespace TokenParser
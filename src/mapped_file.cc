@@ -0,0 +1,93 @@
+#include "../include/token_parser/mapped_file.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TOKEN_PARSER_MAPPED_FILE_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace TokenParser {
+
+MappedFile::MappedFile() : data_(nullptr), size_(0), is_open_(false) {}
+
+MappedFile::MappedFile(const std::string& filename) : MappedFile() {
+  Open(filename);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      is_open_(std::exchange(other.is_open_, false)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this == &other) return *this;
+  Close();
+  data_ = std::exchange(other.data_, nullptr);
+  size_ = std::exchange(other.size_, 0);
+  is_open_ = std::exchange(other.is_open_, false);
+  return *this;
+}
+
+MappedFile::~MappedFile() { Close(); }
+
+bool MappedFile::Open(const std::string& filename) {
+  Close();
+
+#ifdef TOKEN_PARSER_MAPPED_FILE_POSIX
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    ::close(fd);
+    return false;
+  }
+
+  // Empty files can not be mapped, they are open with empty view.
+  std::size_t size = static_cast<std::size_t>(st.st_size);
+  void* data = nullptr;
+  if (size != 0) {
+    data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      ::close(fd);
+      return false;
+    }
+    ::madvise(data, size, MADV_SEQUENTIAL);
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  ::close(fd);
+  data_ = data;
+  size_ = size;
+  is_open_ = true;
+  return true;
+#else
+  (void)filename;
+  return false;
+#endif
+}
+
+void MappedFile::Close() {
+#ifdef TOKEN_PARSER_MAPPED_FILE_POSIX
+  if (data_ != nullptr) ::munmap(data_, size_);
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  is_open_ = false;
+}
+
+bool MappedFile::IsOpen() const { return is_open_; }
+
+std::string_view MappedFile::GetView() const {
+  if (data_ == nullptr) return std::string_view();
+  return std::string_view(static_cast<const char*>(data_), size_);
+}
+
+}  // namespace TokenParser
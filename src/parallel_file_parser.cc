@@ -0,0 +1,272 @@
+#include "../include/token_parser/parallel_file_parser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../include/token_parser/compiled_settings.h"
+#include "../include/token_parser/lexeme.h"
+#include "../include/token_parser/line_counter.h"
+#include "../include/token_parser/mapped_file.h"
+#include "../include/token_parser/position.h"
+#include "../include/token_parser/settings.h"
+#include "../include/token_parser/string_parser.h"
+#include "../include/token_parser/token_buffer.h"
+
+namespace TokenParser {
+
+ParallelFileParser::ParallelFileParser()
+    : ParallelFileParser(Settings(), std::string()) {}
+
+ParallelFileParser::ParallelFileParser(const Settings& settings)
+    : ParallelFileParser(settings, std::string()) {}
+
+ParallelFileParser::ParallelFileParser(Settings&& settings)
+    : ParallelFileParser(std::move(settings), std::string()) {}
+
+ParallelFileParser::ParallelFileParser(const std::string& filename)
+    : ParallelFileParser(Settings(), filename) {}
+
+ParallelFileParser::ParallelFileParser(const Settings& settings,
+                                       const std::string& filename)
+    : settings_(settings),
+      mapped_file_(MappedFile()),
+      file_str_(std::string()),
+      threads_(size_type(std::thread::hardware_concurrency())),
+      chunk_size_(kDefaultChunkSize_) {
+  SetThreads(threads_);
+  SetFile(filename);
+}
+
+ParallelFileParser::ParallelFileParser(Settings&& settings,
+                                       const std::string& filename)
+    : settings_(std::move(settings)),
+      mapped_file_(MappedFile()),
+      file_str_(std::string()),
+      threads_(size_type(std::thread::hardware_concurrency())),
+      chunk_size_(kDefaultChunkSize_) {
+  SetThreads(threads_);
+  SetFile(filename);
+}
+
+ParallelFileParser::~ParallelFileParser() {}
+
+void ParallelFileParser::SetFile(const std::string& filename) {
+  mapped_file_.Close();
+  file_str_.clear();
+
+  if (filename.empty() || mapped_file_.Open(filename)) return;
+
+  std::ifstream file(filename);
+  if (file.fail()) return;
+  std::ostringstream ss;
+  ss << file.rdbuf();
+  file_str_ = ss.str();
+}
+
+void ParallelFileParser::SetSettings(const Settings& settings) {
+  settings_ = settings;
+}
+
+void ParallelFileParser::SetSettings(Settings&& settings) {
+  settings_ = std::move(settings);
+}
+
+void ParallelFileParser::SetThreads(size_type threads) {
+  threads_ = threads == size_type(0) ? size_type(1) : threads;
+}
+
+void ParallelFileParser::SetChunkSize(size_type chunk_size) {
+  chunk_size_ = chunk_size == size_type(0) ? size_type(1) : chunk_size;
+}
+
+const Settings& ParallelFileParser::GetSettings() const { return settings_; }
+
+Settings& ParallelFileParser::GetSettings() { return settings_; }
+
+ParallelFileParser::size_type ParallelFileParser::GetThreads() const {
+  return threads_;
+}
+
+ParallelFileParser::size_type ParallelFileParser::GetChunkSize() const {
+  return chunk_size_;
+}
+
+std::string_view ParallelFileParser::GetView() const {
+  if (mapped_file_.IsOpen()) return mapped_file_.GetView();
+  return std::string_view(file_str_);
+}
+
+ParallelFileParser::size_type ParallelFileParser::Tokenize(
+    TokenBuffer& buffer) const {
+  CompiledSettings::Ptr settings = CompiledSettings::Compile(settings_);
+  std::string_view view = GetView();
+  bool track_positions = buffer.IsTrackingPositions();
+  std::vector<Chunk> chunks = MakeChunks(settings->GetSettings());
+  ForEachChunk(chunks, [&](Chunk& chunk) {
+    StringParser parser(settings);
+    parser.SetStr(view);
+    ParseChunk(parser, chunk);
+    if (track_positions) CountNewlines(view, chunk);
+  });
+
+  // Only the chunks after a lexeme that crosses a chunk end are parsed
+  // again, the loop is over the chunks, not over the lexemes.
+  StringParser parser(settings);
+  parser.SetStr(view);
+  size_type i = 0;
+  size_type n = 0;
+  size_type words_length = 0;
+  size_type line = 1;
+  size_type line_start = 0;
+  for (auto& chunk : chunks) {
+    if (i > chunk.start_) FixChunk(parser, chunk, i);
+    i = chunk.next_i_;
+
+    chunk.first_ = buffer.Size() + n;
+    chunk.word_offset_ = buffer.words_.size() + words_length;
+    n += chunk.lexemes_.size();
+    words_length += chunk.words_length_;
+
+    chunk.base_ = Position(chunk.start_, line, chunk.start_ - line_start + 1);
+    line += chunk.newlines_;
+    if (chunk.newlines_ != size_type(0)) line_start = chunk.line_start_;
+  }
+
+  buffer.Extend(n, words_length);
+  ForEachChunk(chunks,
+               [&](Chunk& chunk) { WriteChunk(view, chunk, buffer); });
+  return n;
+}
+
+std::vector<ParallelFileParser::Chunk> ParallelFileParser::MakeChunks(
+    const Settings& settings) const {
+  std::string_view view = GetView();
+  const std::string& boundaries = settings.GetBoundaryChars();
+
+  std::vector<Chunk> chunks;
+  size_type start = 0;
+  while (start < view.length()) {
+    size_type end = view.length();
+    if (!boundaries.empty() && chunk_size_ < view.length() - start) {
+      size_type pos = view.find_first_of(boundaries, start + chunk_size_);
+      if (pos != view.npos) end = pos + 1;
+    }
+    Chunk chunk = {};
+    chunk.start_ = start;
+    chunk.end_ = end;
+    chunk.next_i_ = end;
+    chunks.push_back(std::move(chunk));
+    start = end;
+  }
+  return chunks;
+}
+
+template <typename Function>
+void ParallelFileParser::ForEachChunk(std::vector<Chunk>& chunks,
+                                      Function function) const {
+  std::atomic<size_type> next_chunk(0);
+  auto worker = [&]() {
+    for (size_type k = next_chunk++; k < chunks.size(); k = next_chunk++)
+      function(chunks[k]);
+  };
+
+  std::vector<std::thread> threads;
+  size_type count = std::min(threads_, chunks.size());
+  for (size_type k = 1; k < count; ++k) threads.emplace_back(worker);
+  worker();
+  for (auto& thread : threads) thread.join();
+}
+
+void ParallelFileParser::ParseChunk(StringParser& parser, Chunk& chunk) {
+  parser.SetI(chunk.start_);
+  while (true) {
+    size_type i = parser.GetI();
+    Lexeme lexeme = parser.NextAny();
+    if (lexeme.IsEnd() || lexeme.GetStart() >= chunk.end_) {
+      chunk.next_i_ = lexeme.IsEnd() ? parser.GetI() : i;
+      return;
+    }
+    chunk.lexemes_.push_back(lexeme);
+    if (lexeme.IsWord()) chunk.words_length_ += lexeme.GetText().length();
+  }
+}
+
+void ParallelFileParser::FixChunk(StringParser& parser, Chunk& chunk,
+                                  size_type i) {
+  auto less_start = [](const Lexeme& lexeme, size_type start) {
+    return lexeme.GetStart() < start;
+  };
+
+  std::vector<Lexeme> lexemes;
+  size_type words_length = 0;
+  parser.SetI(i);
+  while (true) {
+    size_type prev_i = parser.GetI();
+    Lexeme lexeme = parser.NextAny();
+    if (lexeme.IsEnd() || lexeme.GetStart() >= chunk.end_) {
+      chunk.next_i_ = lexeme.IsEnd() ? parser.GetI() : prev_i;
+      break;
+    }
+
+    // The parsing is the same from here on as it depends only on the index.
+    auto iter = std::lower_bound(chunk.lexemes_.begin(), chunk.lexemes_.end(),
+                                 lexeme.GetStart(), less_start);
+    if (iter != chunk.lexemes_.end() &&
+        iter->GetStart() == lexeme.GetStart()) {
+      for (auto dropped = chunk.lexemes_.begin(); dropped != iter; ++dropped)
+        if (dropped->IsWord())
+          chunk.words_length_ -= dropped->GetText().length();
+      lexemes.insert(lexemes.end(), iter, chunk.lexemes_.end());
+      chunk.lexemes_ = std::move(lexemes);
+      return;
+    }
+    lexemes.push_back(lexeme);
+    if (lexeme.IsWord()) words_length += lexeme.GetText().length();
+  }
+  chunk.lexemes_ = std::move(lexemes);
+  chunk.words_length_ = words_length;
+}
+
+void ParallelFileParser::CountNewlines(std::string_view view, Chunk& chunk) {
+  const char* last_newline = nullptr;
+  chunk.newlines_ = LineCounter::CountNewlines(
+      view.data() + chunk.start_, view.data() + chunk.end_, last_newline);
+  if (last_newline != nullptr)
+    chunk.line_start_ = size_type(last_newline - view.data()) + 1;
+}
+
+void ParallelFileParser::WriteChunk(std::string_view view, const Chunk& chunk,
+                                    TokenBuffer& buffer) {
+  size_type i = chunk.first_;
+  size_type word_offset = chunk.word_offset_;
+  if (!buffer.IsTrackingPositions()) {
+    for (const auto& lexeme : chunk.lexemes_) {
+      buffer.SetLexeme(i++, lexeme, word_offset, lexeme.GetStart());
+      if (lexeme.IsWord()) word_offset += lexeme.GetText().length();
+    }
+    return;
+  }
+
+  // The lines are counted from the chunk start as the chunk is in the file.
+  LineCounter line_counter;
+  line_counter.Reset(chunk.base_);
+  std::string_view chars = view.substr(chunk.start_, chunk.end_ - chunk.start_);
+  for (const auto& lexeme : chunk.lexemes_) {
+    buffer.SetLexeme(
+        i++, lexeme, word_offset,
+        line_counter.PositionAt(chars, lexeme.GetStart() - chunk.start_));
+    if (lexeme.IsWord()) word_offset += lexeme.GetText().length();
+  }
+}
+
+const ParallelFileParser::size_type ParallelFileParser::kDefaultChunkSize_ =
+    1 << 22;
+
+}  // namespace TokenParser
@@ -0,0 +1,25 @@
+#include "../include/token_parser/position.h"
+
+namespace TokenParser {
+
+Position::Position() : Position(size_type(0), size_type(1), size_type(1)) {}
+
+Position::Position(size_type offset, size_type line, size_type column)
+    : offset_(offset), line_(line), column_(column) {}
+
+bool Position::operator==(const Position& other) const {
+  return offset_ == other.offset_ && line_ == other.line_ &&
+         column_ == other.column_;
+}
+
+bool Position::operator!=(const Position& other) const {
+  return !this->operator==(other);
+}
+
+Position::size_type Position::GetOffset() const { return offset_; }
+
+Position::size_type Position::GetLine() const { return line_; }
+
+Position::size_type Position::GetColumn() const { return column_; }
+
+}  // namespace TokenParser
@@ -0,0 +1,114 @@
+#include "../include/token_parser/read_ahead_streambuf.h"
+
+#include <condition_variable>
+#include <ios>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace TokenParser {
+
+ReadAheadStreambuf::ReadAheadStreambuf()
+    : source_(nullptr),
+      blocks_(std::vector<Block>()),
+      head_(0),
+      filled_(0),
+      reading_(false),
+      end_(true),
+      stop_(false) {}
+
+ReadAheadStreambuf::~ReadAheadStreambuf() { Close(); }
+
+void ReadAheadStreambuf::Open(std::streambuf* source, size_type buff_size,
+                              size_type count) {
+  Close();
+  if (source == nullptr) return;
+
+  if (buff_size == size_type(0)) buff_size = size_type(1);
+  if (count < kMinCount_) count = kMinCount_;
+  blocks_.resize(count);
+  for (Block& block : blocks_) {
+    block.chars_.resize(buff_size);
+    block.size_ = size_type(0);
+  }
+
+  source_ = source;
+  end_ = false;
+  thread_ = std::thread(&ReadAheadStreambuf::Produce, this);
+}
+
+void ReadAheadStreambuf::Close() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  free_cv_.notify_all();
+  if (thread_.joinable()) thread_.join();
+
+  source_ = nullptr;
+  head_ = size_type(0);
+  filled_ = size_type(0);
+  reading_ = false;
+  end_ = true;
+  stop_ = false;
+  setg(nullptr, nullptr, nullptr);
+}
+
+bool ReadAheadStreambuf::IsOpen() const { return source_ != nullptr; }
+
+ReadAheadStreambuf::int_type ReadAheadStreambuf::underflow() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (reading_) {
+    head_ = (head_ + 1) % blocks_.size();
+    --filled_;
+    reading_ = false;
+    free_cv_.notify_one();
+  }
+
+  filled_cv_.wait(lock, [this]() { return filled_ != 0 || end_; });
+  if (filled_ == size_type(0)) {
+    setg(nullptr, nullptr, nullptr);
+    return traits_type::eof();
+  }
+
+  Block& block = blocks_[head_];
+  reading_ = true;
+  char* data = block.chars_.data();
+  setg(data, data, data + block.size_);
+  return traits_type::to_int_type(*data);
+}
+
+void ReadAheadStreambuf::Produce() {
+  while (true) {
+    size_type slot;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      free_cv_.wait(lock,
+                    [this]() { return stop_ || filled_ < blocks_.size(); });
+      if (stop_) return;
+      slot = (head_ + filled_) % blocks_.size();
+    }
+
+    // The reader takes only the filled blocks, the block is read unlocked.
+    Block& block = blocks_[slot];
+    std::streamsize size = static_cast<std::streamsize>(block.chars_.size());
+    std::streamsize n = source_->sgetn(block.chars_.data(), size);
+
+    bool end = n < size;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (n > 0) {
+        block.size_ = static_cast<size_type>(n);
+        ++filled_;
+      }
+      end_ = end;
+    }
+    filled_cv_.notify_one();
+    if (end) return;
+  }
+}
+
+const ReadAheadStreambuf::size_type ReadAheadStreambuf::kMinCount_ = 2;
+
+}  // namespace TokenParser
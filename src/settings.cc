@@ -1,6 +1,7 @@
 
 #include "../include/token_parser/settings.h"
 
+#include <cctype>
 #include <map>
 #include <string>
 #include <utility>
@@ -12,39 +13,57 @@ Settings::Settings()
       space_chars_(kDefaultSpaceChars_),
       word_delim_chars_(kDefaultWordDelimChars_),
       token_id_is_full_word_(kDefaultTokenIdIsFullWord_),
+      token_id_longest_match_(kDefaultTokenIdLongestMatch_),
       word_may_surrounded_by_qoutes_(kDefaultWordMaySurroundedByQoutes_),
-      appropriate_quotes_(kDefaultAppropriateQuotes_) {}
+      appropriate_quotes_(kDefaultAppropriateQuotes_),
+      keyword_trie_(token_ids_),
+      keyword_hash_(token_ids_),
+      id_index_(token_ids_),
+      keywords_dirty_(false),
+      char_classes_dirty_(true) {
+  BuildCharClasses();
+}
 
 Settings::~Settings() {}
 
 void Settings::SetTokenIds(const TokenIds& token_ids) {
   token_ids_ = token_ids;
+  BuildKeywords();
 }
 
 void Settings::SetTokenIds(TokenIds&& token_ids) {
   token_ids_ = std::move(token_ids);
+  BuildKeywords();
 }
 
 void Settings::SetSpaceChars(const std::string& space_chars) {
   space_chars_ = space_chars;
+  BuildCharClasses();
 }
 
 void Settings::SetSpaceChars(std::string&& space_chars) {
   space_chars_ = std::move(space_chars);
+  BuildCharClasses();
 }
 
 void Settings::SetWordDelim(const std::string& word_delim_chars) {
   word_delim_chars_ = word_delim_chars;
+  BuildCharClasses();
 }
 
 void Settings::SetWordDelim(std::string&& word_delim_chars) {
   word_delim_chars_ = std::move(word_delim_chars);
+  BuildCharClasses();
 }
 
 void Settings::SetTokenIdIsFullWord(bool token_id_is_full_word) {
   token_id_is_full_word_ = token_id_is_full_word;
 }
 
+void Settings::SetTokenIdLongestMatch(bool token_id_longest_match) {
+  token_id_longest_match_ = token_id_longest_match;
+}
+
 void Settings::SetWordMaySurrondedByQoutes(bool word_may_surrounded_by_qoutes) {
   word_may_surrounded_by_qoutes_ = word_may_surrounded_by_qoutes;
 }
@@ -52,19 +71,31 @@ void Settings::SetWordMaySurrondedByQoutes(bool word_may_surrounded_by_qoutes) {
 void Settings::SetAppropriateQuotes(
     const AppropriateQuotes& appropriate_quotes) {
   appropriate_quotes_ = appropriate_quotes;
+  BuildCharClasses();
 }
 
 void Settings::SetAppropriateQuotes(AppropriateQuotes&& appropriate_quotes) {
   appropriate_quotes_ = std::move(appropriate_quotes);
+  BuildCharClasses();
 }
 
-Settings::TokenIds& Settings::GetTokenIds() { return token_ids_; }
+Settings::TokenIds& Settings::GetTokenIds() {
+  keywords_dirty_ = true;
+  return token_ids_;
+}
 
-std::string& Settings::GetSpaceChars() { return space_chars_; }
+std::string& Settings::GetSpaceChars() {
+  char_classes_dirty_ = true;
+  return space_chars_;
+}
 
-std::string& Settings::GetWordDelimChars() { return word_delim_chars_; }
+std::string& Settings::GetWordDelimChars() {
+  char_classes_dirty_ = true;
+  return word_delim_chars_;
+}
 
 Settings::AppropriateQuotes& Settings::GetAppropriateQuotes() {
+  char_classes_dirty_ = true;
   return appropriate_quotes_;
 }
 
@@ -78,6 +109,10 @@ const std::string& Settings::GetWordDelimChars() const {
 
 bool Settings::GetTokenIdIsFullWord() const { return token_id_is_full_word_; }
 
+bool Settings::GetTokenIdLongestMatch() const {
+  return token_id_longest_match_;
+}
+
 bool Settings::GetWordMaySurrondedByQoutes() const {
   return word_may_surrounded_by_qoutes_;
 }
@@ -86,10 +121,86 @@ const Settings::AppropriateQuotes& Settings::GetAppropriateQuotes() const {
   return appropriate_quotes_;
 }
 
+const KeywordTrie& Settings::GetKeywordTrie() const {
+  if (keywords_dirty_) BuildKeywords();
+  return keyword_trie_;
+}
+
+const KeywordHash& Settings::GetKeywordHash() const {
+  if (keywords_dirty_) BuildKeywords();
+  return keyword_hash_;
+}
+
+const IdIndex& Settings::GetIdIndex() const {
+  if (keywords_dirty_) BuildKeywords();
+  return id_index_;
+}
+
+const Settings::CharClasses& Settings::GetCharClasses() const {
+  if (char_classes_dirty_) BuildCharClasses();
+  return char_classes_;
+}
+
+const Settings::CloseQuotes& Settings::GetCloseQuotes() const {
+  if (char_classes_dirty_) BuildCharClasses();
+  return close_quotes_;
+}
+
+const CharSet& Settings::GetSpaceCharSet() const {
+  if (char_classes_dirty_) BuildCharClasses();
+  return space_char_set_;
+}
+
+const CharSet& Settings::GetWordDelimCharSet() const {
+  if (char_classes_dirty_) BuildCharClasses();
+  return word_delim_char_set_;
+}
+
+const std::string& Settings::GetBoundaryChars() const {
+  if (char_classes_dirty_) BuildCharClasses();
+  return boundary_chars_;
+}
+
+void Settings::BuildKeywords() const {
+  keyword_trie_.Build(token_ids_);
+  keyword_hash_.Build(token_ids_);
+  id_index_.Build(token_ids_);
+  keywords_dirty_ = false;
+}
+
+void Settings::BuildCharClasses() const {
+  char_classes_.fill(0);
+  close_quotes_.fill('\0');
+
+  for (char ch : space_chars_)
+    char_classes_[static_cast<unsigned char>(ch)] |= kCharClassSpace;
+  for (char ch : word_delim_chars_)
+    char_classes_[static_cast<unsigned char>(ch)] |= kCharClassWordDelim;
+  for (auto quotes : appropriate_quotes_) {
+    char_classes_[static_cast<unsigned char>(quotes.first)] |= kCharClassQoute;
+    close_quotes_[static_cast<unsigned char>(quotes.first)] = quotes.second;
+  }
+
+  space_char_set_.Assign(space_chars_);
+  word_delim_char_set_.Assign(word_delim_chars_);
+
+  boundary_chars_.clear();
+  for (char ch : word_delim_chars_) {
+    unsigned char uch = static_cast<unsigned char>(ch);
+    if ((char_classes_[uch] & kCharClassSpace) && std::isspace(uch))
+      boundary_chars_.push_back(ch);
+  }
+  if (boundary_chars_.empty() && !word_delim_chars_.empty())
+    boundary_chars_.push_back(word_delim_chars_[0]);
+
+  char_classes_dirty_ = false;
+}
+
 const Settings::TokenIds Settings::kDefaultTokenIds_ = {};
 const std::string Settings::kDefaultSpaceChars_ = "\n \f\r\t\v";
 const std::string Settings::kDefaultWordDelimChars_ = "\n \f\r\t\v";
 const bool Settings::kDefaultTokenIdIsFullWord_ = true;
+const bool Settings::kDefaultTokenIdLongestMatch_ = false;
 const bool Settings::kDefaultWordMaySurroundedByQoutes_ = false;
 const Settings::AppropriateQuotes Settings::kDefaultAppropriateQuotes_ = {
     {'"', '"'}, {'\'', '\''}};
@@ -1,16 +1,26 @@
 #include "../include/token_parser/string_parser.h"
 
+#include <cctype>
+#include <charconv>
 #include <cstdlib>
+#include <limits>
 #include <string>
+#include <string_view>
 #include <utility>
 
+#include "../include/token_parser/char_set.h"
+#include "../include/token_parser/compiled_settings.h"
+#include "../include/token_parser/lexeme.h"
+#include "../include/token_parser/line_counter.h"
+#include "../include/token_parser/position.h"
 #include "../include/token_parser/settings.h"
 #include "../include/token_parser/token.h"
+#include "../include/token_parser/token_buffer.h"
 
 namespace TokenParser {
 
 StringParser::StringParser()
-    : StringParser(Settings(), nullptr, size_type(0)) {}
+    : StringParser(CompiledSettings::GetDefault(), nullptr, size_type(0)) {}
 
 StringParser::StringParser(const Settings& settings)
     : StringParser(settings, nullptr, size_type(0)) {}
@@ -19,59 +29,152 @@ StringParser::StringParser(Settings&& settings)
     : StringParser(std::move(settings), nullptr, size_type(0)) {}
 
 StringParser::StringParser(const std::string* str, size_type i)
-    : StringParser(Settings(), str, i) {}
+    : StringParser(CompiledSettings::GetDefault(), str, i) {}
+
+StringParser::StringParser(std::string_view str, size_type i)
+    : StringParser(CompiledSettings::GetDefault(), str, i) {}
 
 StringParser::StringParser(const Settings& settings, const std::string* str,
                            size_type i)
-    : settings_(settings), str_(str), i_(i) {}
+    : StringParser(CompiledSettings::Compile(settings), str, i) {}
 
 StringParser::StringParser(Settings&& settings, const std::string* str,
                            size_type i)
-    : settings_(std::move(settings)), str_(str), i_(i) {}
+    : StringParser(CompiledSettings::Compile(std::move(settings)), str, i) {}
+
+StringParser::StringParser(const Settings& settings, std::string_view str,
+                           size_type i)
+    : StringParser(CompiledSettings::Compile(settings), str, i) {}
+
+StringParser::StringParser(Settings&& settings, std::string_view str,
+                           size_type i)
+    : StringParser(CompiledSettings::Compile(std::move(settings)), str, i) {}
+
+StringParser::StringParser(CompiledSettings::Ptr settings)
+    : StringParser(std::move(settings), nullptr, size_type(0)) {}
+
+StringParser::StringParser(CompiledSettings::Ptr settings,
+                           const std::string* str, size_type i)
+    : settings_(std::move(settings)),
+      str_(str),
+      view_(),
+      i_(i),
+      cached_i_(0),
+      cached_start_(0),
+      cached_data_(nullptr),
+      cached_length_(0),
+      memo_(),
+      line_counter_() {}
+
+StringParser::StringParser(CompiledSettings::Ptr settings,
+                           std::string_view str, size_type i)
+    : settings_(std::move(settings)),
+      str_(nullptr),
+      view_(str),
+      i_(i),
+      cached_i_(0),
+      cached_start_(0),
+      cached_data_(nullptr),
+      cached_length_(0),
+      memo_(),
+      line_counter_() {}
 
 StringParser::~StringParser() {}
 
 void StringParser::SetStr(const std::string* str) {
   str_ = str;
+  view_ = std::string_view();
   i_ = size_type(0);
+  InvalidateCache();
+  line_counter_.Reset();
 }
 
-void StringParser::SetI(size_type i) { i_ = i; }
+void StringParser::SetStr(std::string_view str) {
+  str_ = nullptr;
+  view_ = str;
+  i_ = size_type(0);
+  InvalidateCache();
+  line_counter_.Reset();
+}
+
+void StringParser::SetStr(const char* data, size_type size) {
+  SetStr(std::string_view(data, size));
+}
+
+void StringParser::SetI(size_type i) {
+  // The chars may be changed in place before the rewind.
+  i_ = i;
+  InvalidateCache();
+}
+
+void StringParser::SetBasePosition(const Position& position) {
+  line_counter_.Reset(position);
+}
+
+void StringParser::Reset() {
+  str_ = nullptr;
+  view_ = std::string_view();
+  i_ = size_type(0);
+  InvalidateCache();
+  line_counter_.Reset();
+}
 
 void StringParser::SetSettings(const Settings& settings) {
-  settings_ = settings;
+  settings_ = CompiledSettings::Compile(settings);
+  InvalidateCache();
 }
 
 void StringParser::SetSettings(Settings&& settings) {
+  settings_ = CompiledSettings::Compile(std::move(settings));
+  InvalidateCache();
+}
+
+void StringParser::SetSettings(CompiledSettings::Ptr settings) {
   settings_ = std::move(settings);
+  InvalidateCache();
 }
 
 const std::string* StringParser::GetStr() const { return str_; }
 
+std::string_view StringParser::GetView() const { return Str(); }
+
 StringParser::size_type StringParser::GetI() const { return i_; }
 
-const Settings& StringParser::GetSettings() const { return settings_; }
+const Settings& StringParser::GetSettings() const {
+  return ParsingSettings();
+}
 
-Settings& StringParser::GetSettings() { return settings_; }
+const CompiledSettings::Ptr& StringParser::GetCompiledSettings() const {
+  return settings_;
+}
+
+Position StringParser::GetPosition() const { return GetPosition(i_); }
+
+Position StringParser::GetPosition(size_type i) const {
+  return line_counter_.PositionAt(Str(), i);
+}
 
 bool StringParser::IsEnd() const {
-  if (str_ == nullptr) return true;
+  if (!HasStr()) return true;
   size_type i = NextParsingStart();
-  if (i >= str_->length()) return true;
+  if (i >= Str().length()) return true;
   return false;
 }
 
-std::string StringParser::NextWord() {
-  if (str_ == nullptr) return "";
-  WordIdx word_idx = NextWordIdx();
+std::string StringParser::NextWord() { return std::string(NextWordView()); }
+
+std::string_view StringParser::NextWordView() {
+  if (!HasStr()) return std::string_view();
+  WordIdx word_idx;
+  if (!MemoWord(word_idx)) word_idx = NextWordIdx();
   i_ = word_idx.start_ + word_idx.len_;
-  return WordIdxToString(word_idx);
+  return WordIdxToView(word_idx);
 }
 
 Token StringParser::NextInt() {
-  if (str_ == nullptr) return Token(Token::Type::kTypeNull);
+  if (!HasStr()) return Token(Token::Type::kTypeNull);
   size_type i = NextParsingStart();
-  if (i >= str_->length()) return Token(Token::Type::kTypeNull);
+  if (i >= Str().length()) return Token(Token::Type::kTypeNull);
 
   size_type len;
   Token::int_type value = StrToInt(i, len);
@@ -82,9 +185,9 @@ Token StringParser::NextInt() {
 }
 
 Token StringParser::NextUint() {
-  if (str_ == nullptr) return Token(Token::Type::kTypeNull);
+  if (!HasStr()) return Token(Token::Type::kTypeNull);
   size_type i = NextParsingStart();
-  if (i >= str_->length()) return Token(Token::Type::kTypeNull);
+  if (i >= Str().length()) return Token(Token::Type::kTypeNull);
 
   size_type len;
   Token::uint_type value = StrToUint(i, len);
@@ -95,9 +198,9 @@ Token StringParser::NextUint() {
 }
 
 Token StringParser::NextFloat() {
-  if (str_ == nullptr) return Token(Token::Type::kTypeNull);
+  if (!HasStr()) return Token(Token::Type::kTypeNull);
   size_type i = NextParsingStart();
-  if (i >= str_->length()) return Token(Token::Type::kTypeNull);
+  if (i >= Str().length()) return Token(Token::Type::kTypeNull);
 
   size_type len;
   Token::float_type value = StrToFloat(i, len);
@@ -108,137 +211,580 @@ Token StringParser::NextFloat() {
 }
 
 Token StringParser::NextId() {
-  if (str_ == nullptr) return Token(Token::Type::kTypeNull);
+  if (!HasStr()) return Token(Token::Type::kTypeNull);
   size_type i = NextParsingStart();
-  if (i >= str_->length()) return Token(Token::Type::kTypeNull);
+  if (i >= Str().length()) return Token(Token::Type::kTypeNull);
 
-  for (auto token_id : settings_.GetTokenIds()) {
-    if (IsIdNext(i, token_id.second)) {
-      i_ = i + token_id.second.length();
-      return Token(token_id.first);
-    }
-  }
+  bool found;
+  Token::id_type id;
+  size_type len;
+  if (!MemoId(found, id, len)) found = IdAt(i, id, len);
+  if (!found) return Token(Token::Type::kTypeNull);
 
-  return Token(Token::Type::kTypeNull);
+  i_ = i + len;
+  return Token(id);
 }
 
 Token StringParser::NextThisId(Token::id_type id) {
-  if (str_ == nullptr) return Token(Token::Type::kTypeNull);
+  if (!HasStr()) return Token(Token::Type::kTypeNull);
   size_type i = NextParsingStart();
-  if (i >= str_->length()) return Token(Token::Type::kTypeNull);
+  if (i >= Str().length()) return Token(Token::Type::kTypeNull);
 
-  auto iter = settings_.GetTokenIds().find(id);
-  if (iter == settings_.GetTokenIds().end())
+  // A peeked id of other text does not mean that this id is not next, it may
+  // be a prefix of the peeked one.
+  bool found;
+  Token::id_type memo_id;
+  size_type len;
+  if (MemoId(found, memo_id, len) && found && memo_id == id) {
+    i_ = i + len;
+    return Token(id);
+  }
+
+  std::string_view text;
+  if (!ParsingSettings().GetIdIndex().Find(id, text))
     return Token(Token::Type::kTypeNull);
 
-  if (IsIdNext(i, iter->second)) {
-    i_ = i + iter->second.length();
-    return Token(iter->first);
+  if (IsIdNext(i, text)) {
+    i_ = i + text.length();
+    return Token(id);
   }
 
   return Token(Token::Type::kTypeNull);
 }
 
+Lexeme StringParser::NextAny() {
+  if (!HasStr()) return Lexeme();
+  const PeekMemo* memo = FindMemo();
+  if (memo != nullptr && memo->has_any_) {
+    const Lexeme& lexeme = memo->any_;
+    if (!lexeme.IsEnd()) i_ = lexeme.GetStart() + lexeme.GetText().length();
+    return lexeme;
+  }
+
+  size_type i = NextParsingStart();
+  std::string_view str = Str();
+  if (i >= str.length()) return Lexeme();
+
+  bool found;
+  Token::id_type id;
+  size_type len;
+  if (memo == nullptr || !MemoId(*memo, found, id, len))
+    found = IdAt(i, id, len);
+  if (found) {
+    i_ = i + len;
+    return Lexeme(Token(id), str.substr(i, len), i);
+  }
+
+  Token number = NumberAt(i, len);
+  if (!number.IsNull()) {
+    i_ = i + len;
+    return Lexeme(number, str.substr(i, len), i);
+  }
+
+  WordIdx word_idx = WordIdxAt(i);
+  i_ = word_idx.start_ + word_idx.len_;
+  return Lexeme(WordIdxToView(word_idx), i);
+}
+
+StringParser::size_type StringParser::NextBatch(Lexeme* lexemes,
+                                                size_type count) {
+  size_type n = 0;
+  while (n < count) {
+    lexemes[n] = NextAny();
+    if (lexemes[n].IsEnd()) break;
+    ++n;
+  }
+  return n;
+}
+
+StringParser::size_type StringParser::NextBatch(TokenBuffer& buffer,
+                                                size_type count) {
+  // The lines and the columns of the batch are counted after it in one pass.
+  bool positions = buffer.IsTrackingPositions();
+  size_type first = buffer.Size();
+  size_type base =
+      positions ? line_counter_.GetBase().GetOffset() : size_type(0);
+  size_type n = 0;
+  for (; n < count; ++n) {
+    Lexeme lexeme = NextAny();
+    if (lexeme.IsEnd()) break;
+    buffer.PushLexeme(lexeme, base + lexeme.GetStart());
+  }
+  if (positions) CountPositions(buffer, first);
+  return n;
+}
+
+Token StringParser::PeekId() {
+  if (!HasStr()) return Token(Token::Type::kTypeNull);
+  size_type i = NextParsingStart();
+  if (i >= Str().length()) return Token(Token::Type::kTypeNull);
+
+  bool found;
+  Token::id_type id;
+  size_type len;
+  if (!MemoId(found, id, len)) {
+    PeekMemo& memo = MemoAtI();
+    found = IdAt(i, id, len);
+    memo.has_id_ = true;
+    memo.id_found_ = found;
+    memo.id_ = id;
+    memo.id_len_ = len;
+  }
+  if (!found) return Token(Token::Type::kTypeNull);
+  return Token(id);
+}
+
+std::string StringParser::PeekWord() { return std::string(PeekWordView()); }
+
+std::string_view StringParser::PeekWordView() {
+  if (!HasStr()) return std::string_view();
+  WordIdx word_idx;
+  if (!MemoWord(word_idx)) {
+    PeekMemo& memo = MemoAtI();
+    word_idx = NextWordIdx();
+    memo.has_word_ = true;
+    memo.word_idx_ = word_idx;
+  }
+  return WordIdxToView(word_idx);
+}
+
+Lexeme StringParser::PeekAny() {
+  if (!HasStr()) return Lexeme();
+  PeekMemo& memo = MemoAtI();
+  if (!memo.has_any_) {
+    size_type i = i_;
+    memo.any_ = NextAny();
+    memo.has_any_ = true;
+    i_ = i;
+  }
+  return memo.any_;
+}
+
+void StringParser::ExtendStr(const char* data, size_type size) {
+  LineCounter line_counter = line_counter_;
+  SetStr(data, size);
+  line_counter_ = line_counter;
+}
+
 bool StringParser::IsSpace(char ch) const {
-  for (auto i : settings_.GetSpaceChars())
-    if (ch == i) return true;
-  return false;
+  return IsCharClass(ch, Settings::kCharClassSpace);
 }
 
 bool StringParser::IsWordDelim(char ch) const {
-  for (auto i : settings_.GetWordDelimChars())
-    if (ch == i) return true;
-  return false;
+  return IsCharClass(ch, Settings::kCharClassWordDelim);
 }
 
 bool StringParser::IsQoute(char ch) const {
-  for (auto i : settings_.GetAppropriateQuotes())
-    if (ch == i.first) return true;
-  return false;
+  return IsCharClass(ch, Settings::kCharClassQoute);
+}
+
+bool StringParser::IsCharClass(char ch, unsigned char char_class) const {
+  return ParsingSettings().GetCharClasses()[static_cast<unsigned char>(ch)] &
+         char_class;
 }
 
 StringParser::size_type StringParser::NextParsingStart() const {
-  size_type i = i_;
-  while (i < str_->length() && IsSpace((*str_)[i])) ++i;
-  return i;
+  std::string_view str = Str();
+  if (i_ >= str.length()) return i_;
+
+  // IsEnd() and Next*() of this parser and of StreamParser ask for the start
+  // several times per lexeme, the spaces are skipped once.
+  if (cached_i_ == i_ && cached_data_ == str.data() &&
+      cached_length_ == str.length())
+    return cached_start_;
+
+  const char* first = str.data();
+  const char* last = first + str.length();
+  const CharSet& space_char_set = ParsingSettings().GetSpaceCharSet();
+  cached_i_ = i_;
+  cached_data_ = str.data();
+  cached_length_ = str.length();
+  cached_start_ = space_char_set.FindNot(first + i_, last) - first;
+  return cached_start_;
+}
+
+void StringParser::InvalidateCache() {
+  cached_data_ = nullptr;
+  memo_.data_ = nullptr;
+}
+
+StringParser::PeekMemo& StringParser::MemoAtI() {
+  if (FindMemo() != nullptr) return memo_;
+
+  std::string_view str = Str();
+  memo_.i_ = i_;
+  memo_.data_ = str.data();
+  memo_.length_ = str.length();
+  memo_.has_id_ = false;
+  memo_.has_word_ = false;
+  memo_.has_any_ = false;
+  return memo_;
+}
+
+const StringParser::PeekMemo* StringParser::FindMemo() const {
+  // i_ differs after every Next*, it is compared first. The memo is dropped
+  // by SetStr(), the chars are compared for the chars set without it.
+  if (memo_.i_ != i_ || memo_.data_ == nullptr) return nullptr;
+  std::string_view str = Str();
+  if (memo_.data_ != str.data() || memo_.length_ != str.length())
+    return nullptr;
+  return &memo_;
+}
+
+bool StringParser::MemoId(bool& found, Token::id_type& id,
+                          size_type& len) const {
+  const PeekMemo* memo = FindMemo();
+  if (memo == nullptr) return false;
+  return MemoId(*memo, found, id, len);
+}
+
+bool StringParser::MemoId(const PeekMemo& memo, bool& found,
+                          Token::id_type& id, size_type& len) {
+  if (memo.has_id_) {
+    found = memo.id_found_;
+    id = memo.id_;
+    len = memo.id_len_;
+    return true;
+  }
+
+  // NextAny() takes an id first, so a lexeme that is not an id means that
+  // no id is next.
+  if (!memo.has_any_) return false;
+  found = memo.any_.GetToken().IsId();
+  if (found) {
+    id = memo.any_.GetToken().GetId();
+    len = memo.any_.GetText().length();
+  }
+  return true;
+}
+
+bool StringParser::MemoWord(WordIdx& word_idx) const {
+  const PeekMemo* memo = FindMemo();
+  if (memo == nullptr) return false;
+  if (memo->has_word_) {
+    word_idx = memo->word_idx_;
+    return true;
+  }
+
+  if (!memo->has_any_ || !memo->any_.IsWord()) return false;
+  word_idx = WordIdx{memo->any_.GetStart(), memo->any_.GetText().length()};
+  return true;
+}
+
+bool StringParser::IdAt(size_type i, Token::id_type& id,
+                        size_type& len) const {
+  // The result is the smallest id that matches, as if ids were tried one by
+  // one in the map order, or the longest one. Prefixes come in order of
+  // increasing length, so the last one that matches is the longest.
+  std::string_view str = Str();
+  const char* first = str.data() + i;
+  const char* last = str.data() + str.length();
+  const Settings& settings = ParsingSettings();
+
+  // Only the whole word may be a full word id if no id has a word delim
+  // char inside, one hash finds it.
+  if (settings.GetTokenIdIsFullWord() && settings_->GetIdIsWord() &&
+      first != last && !IsWordDelim(*first)) {
+    const char* end = settings.GetWordDelimCharSet().Find(first, last);
+    if (!settings.GetKeywordHash().Find(std::string_view(first, end - first),
+                                        id))
+      return false;
+    len = end - first;
+    return true;
+  }
+
+  bool found = false;
+  bool longest_match = settings.GetTokenIdLongestMatch();
+  settings.GetKeywordTrie().ForEachPrefix(
+      first, last, [&](size_type word_len, Token::id_type word_id) {
+        if (found && !longest_match && id <= word_id) return;
+        if (!IsIdEnd(i, word_len)) return;
+        found = true;
+        id = word_id;
+        len = word_len;
+      });
+  return found;
+}
+
+Token StringParser::NumberAt(size_type i, size_type& len) const {
+  std::string_view str = Str();
+  const char* first = str.data() + i;
+  const char* last = str.data() + str.length();
+
+  // Only a digit, maybe after a sign or a point, starts a number, so words
+  // like "inf" or "e5" stay words.
+  const char* p = first;
+  bool negative = p != last && *p == '-';
+  if (p != last && (*p == '+' || *p == '-')) ++p;
+  bool digit = p != last && (IsDigit(*p) || (*p == '.' && p + 1 != last &&
+                                             IsDigit(*(p + 1))));
+  if (!digit) return Token(Token::Type::kTypeNull);
+
+  size_type int_len;
+  Token::uint_type uint_value = StrToUint(i, int_len);
+  const char* end = first + int_len;
+  if (int_len == size_type(0) ||
+      (end != last && (*end == '.' || *end == 'e' || *end == 'E'))) {
+    size_type float_len;
+    Token::float_type float_value = StrToFloat(i, float_len);
+    if (float_len > int_len) {
+      len = float_len;
+      return Token(float_value);
+    }
+  }
+
+  if (negative) return Token(StrToInt(i, len));
+  len = int_len;
+  return Token(uint_value);
 }
 
 Token::int_type StringParser::StrToInt(size_type start, size_type& len) const {
-  const char* pstart = str_->c_str() + start;
-  char* pend;
-  long long ans = std::strtoll(pstart, &pend, 10);
+  std::string_view str = Str();
+  const char* first = str.data() + start;
+  const char* last = str.data() + str.length();
+
+  bool negative;
+  const char* digits = SkipNumberSpacesAndSign(first, last, negative);
+  Token::uint_type value;
+  bool overflow;
+  const char* end = ParseDigits(digits, last, value, overflow);
+  if (end == digits) {
+    len = size_type(0);
+    return Token::int_type(0);
+  }
 
-  len = pend - pstart;
-  return static_cast<Token::int_type>(ans);
+  // Out of range values are clamped as strtoll does.
+  const Token::uint_type kMax = std::numeric_limits<Token::int_type>::max();
+  len = end - first;
+  if (negative) {
+    if (overflow || value > kMax + 1)
+      return std::numeric_limits<Token::int_type>::min();
+    if (value == Token::uint_type(0)) return Token::int_type(0);
+    return -static_cast<Token::int_type>(value - 1) - 1;
+  }
+  if (overflow || value > kMax)
+    return std::numeric_limits<Token::int_type>::max();
+  return static_cast<Token::int_type>(value);
 }
 
 Token::uint_type StringParser::StrToUint(size_type start,
                                          size_type& len) const {
-  const char* pstart = str_->c_str() + start;
-  char* pend;
-  unsigned long long ans = std::strtoull(pstart, &pend, 10);
+  std::string_view str = Str();
+  const char* first = str.data() + start;
+  const char* last = str.data() + str.length();
+
+  bool negative;
+  const char* digits = SkipNumberSpacesAndSign(first, last, negative);
+  Token::uint_type value;
+  bool overflow;
+  const char* end = ParseDigits(digits, last, value, overflow);
+  if (end == digits) {
+    len = size_type(0);
+    return Token::uint_type(0);
+  }
 
-  len = pend - pstart;
-  return static_cast<Token::uint_type>(ans);
+  // As strtoull does, out of range values are clamped and a negative value
+  // is negated in unsigned type.
+  len = end - first;
+  if (overflow) return std::numeric_limits<Token::uint_type>::max();
+  if (negative) return Token::uint_type(0) - value;
+  return value;
 }
 
 Token::float_type StringParser::StrToFloat(size_type start,
                                            size_type& len) const {
-  const char* pstart = str_->c_str() + start;
+  std::string_view str = Str();
+  const char* first = str.data() + start;
+  const char* last = str.data() + str.length();
+
+  bool negative;
+  const char* p = SkipNumberSpacesAndSign(first, last, negative);
+  bool digit = p != last && (IsDigit(*p) || (*p == '.' && p + 1 != last &&
+                                             IsDigit(*(p + 1))));
+  bool hex = p != last && *p == '0' && p + 1 != last &&
+             (*(p + 1) == 'x' || *(p + 1) == 'X');
+
+  if (digit && !hex) {
+    Token::float_type value;
+    auto res = std::from_chars(p, last, value, std::chars_format::general);
+    if (res.ec == std::errc()) {
+      len = res.ptr - first;
+      return negative ? -value : value;
+    }
+  }
+
+  // Hex floats, infinities, nans and out of range values are rare, they are
+  // parsed by strtod.
+  bool inf_or_nan = IsInfOrNan(p, last);
+  if (!digit && !inf_or_nan) {
+    len = size_type(0);
+    return Token::float_type(0);
+  }
+
+  NumberBuff buff;
+  const char* pstart = NumberCStr(start, buff);
   char* pend;
-  long double ans = std::strtold(pstart, &pend);
+  double ans = std::strtod(pstart, &pend);
 
   len = pend - pstart;
   return static_cast<Token::float_type>(ans);
 }
 
-bool StringParser::IsIdNext(size_type i, const std::string& word) const {
-  if (word.length() == 1 && IsWordDelim(word[0]) && word[0] == (*str_)[i]) {
-    return true;
+const char* StringParser::SkipNumberSpacesAndSign(const char* first,
+                                                  const char* last,
+                                                  bool& negative) {
+  // strto* functions skip the spaces of the "C" locale.
+  while (first != last &&
+         (*first == ' ' || (*first >= '\t' && *first <= '\r')))
+    ++first;
+
+  negative = false;
+  if (first != last && (*first == '+' || *first == '-')) {
+    negative = *first == '-';
+    ++first;
   }
+  return first;
+}
 
-  size_type stri = i;
-  size_type wordi = 0;
-  while (stri < str_->length() && wordi < word.length()) {
-    if ((*str_)[stri] != word[wordi]) return false;
+const char* StringParser::ParseDigits(const char* first, const char* last,
+                                      Token::uint_type& value,
+                                      bool& overflow) {
+  const Token::uint_type kMax = std::numeric_limits<Token::uint_type>::max();
+  value = Token::uint_type(0);
+  overflow = false;
+  for (; first != last && IsDigit(*first); ++first) {
+    Token::uint_type digit = static_cast<Token::uint_type>(*first - '0');
+    if (value > (kMax - digit) / 10) overflow = true;
+    value = value * 10 + digit;
+  }
+  return first;
+}
+
+bool StringParser::IsDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+const Settings& StringParser::ParsingSettings() const {
+  return settings_->GetSettings();
+}
+
+void StringParser::CountPositions(TokenBuffer& buffer, size_type first) const {
+  buffer.CountPositions(first, Str(), line_counter_);
+}
+
+bool StringParser::HasStr() const {
+  return str_ != nullptr || view_.data() != nullptr;
+}
+
+std::string_view StringParser::Str() const {
+  if (str_ != nullptr) return std::string_view(*str_);
+  return view_;
+}
 
-    ++stri;
-    ++wordi;
+const char* StringParser::NumberCStr(size_type start, NumberBuff& buff) const {
+  if (str_ != nullptr) return str_->c_str() + start;
+
+  // strto* functions need NUL-terminated chars, the leading spaces and the
+  // chars that may be a part of a number are copied.
+  size_type end = start;
+  while (end < view_.length() &&
+         std::isspace(static_cast<unsigned char>(view_[end])))
+    ++end;
+  while (end < view_.length() && IsNumberChar(view_[end])) ++end;
+
+  size_type len = end - start;
+  if (len < sizeof(buff.small_)) {
+    view_.copy(buff.small_, len, start);
+    buff.small_[len] = '\0';
+    return buff.small_;
   }
 
-  if (stri >= str_->length() && wordi >= word.length()) return true;
-  if (stri >= str_->length()) return false;
-  if (settings_.GetTokenIdIsFullWord() && !IsWordDelim((*str_)[stri]))
+  buff.big_.assign(view_.data() + start, len);
+  return buff.big_.c_str();
+}
+
+bool StringParser::IsInfOrNan(const char* first, const char* last) {
+  if (last - first < 3) return false;
+  char lower[3];
+  for (int k = 0; k < 3; ++k)
+    lower[k] = static_cast<char>(
+        std::tolower(static_cast<unsigned char>(first[k])));
+  return std::string_view(lower, 3) == "inf" ||
+         std::string_view(lower, 3) == "nan";
+}
+
+bool StringParser::IsNumberChar(char ch) {
+  if (std::isalnum(static_cast<unsigned char>(ch))) return true;
+  switch (ch) {
+    case '.':
+    case '+':
+    case '-':
+    case '_':
+    case '(':
+    case ')':
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
+
+bool StringParser::IsIdNext(size_type i, std::string_view word) const {
+  std::string_view str = Str();
+  if (i > str.length() || str.length() - i < word.length()) return false;
+  if (str.compare(i, word.length(), word) != 0) return false;
+  return IsIdEnd(i, word.length());
+}
+
+bool StringParser::IsIdEnd(size_type i, size_type len) const {
+  std::string_view str = Str();
+  if (len == 1 && IsWordDelim(str[i])) return true;
+
+  size_type end = i + len;
+  if (end >= str.length()) return true;
+  if (ParsingSettings().GetTokenIdIsFullWord() && !IsWordDelim(str[end]))
     return false;
   return true;
 }
 
 StringParser::WordIdx StringParser::NextWordIdx() const {
-  size_type start = NextParsingStart();
-  if (start >= str_->length()) return WordIdx{(size_type(0)), (size_type(0))};
+  return WordIdxAt(NextParsingStart());
+}
 
-  if (settings_.GetWordMaySurrondedByQoutes() && IsQoute((*str_)[start])) {
+StringParser::WordIdx StringParser::WordIdxAt(size_type start) const {
+  std::string_view str = Str();
+  if (start >= str.length()) return WordIdx{(size_type(0)), (size_type(0))};
+
+  bool may_be_qouted = ParsingSettings().GetWordMaySurrondedByQoutes();
+  if (may_be_qouted && IsQoute(str[start])) {
     return NextWordIdxQouted(start);
-  } else if (IsWordDelim((*str_)[start])) {
+  } else if (IsWordDelim(str[start])) {
     return WordIdx{start, size_type(1)};
   }
 
-  size_type len = size_type(0);
-  while (start + len < str_->length() && !IsWordDelim((*str_)[start + len]))
-    ++len;
+  const char* first = str.data() + start;
+  const char* last = str.data() + str.length();
+  const CharSet& delim_char_set = ParsingSettings().GetWordDelimCharSet();
+  size_type len = delim_char_set.Find(first, last) - first;
   return WordIdx{start, len};
 }
 
 StringParser::WordIdx StringParser::NextWordIdxQouted(size_type start) const {
-  char cq = settings_.GetAppropriateQuotes().find((*str_)[start])->second;
-  size_type len = size_type(1);
-  while (start + len < str_->length() && (*str_)[start + len] != cq) ++len;
-  if ((*str_)[start + len] == cq) ++len;
-  return WordIdx{start, len};
+  std::string_view str = Str();
+  char cq = CloseQoute(str[start]);
+  size_type end = str.find(cq, start + 1);
+  if (end == str.npos) return WordIdx{start, str.length() - start};
+  return WordIdx{start, end + 1 - start};
+}
+
+char StringParser::CloseQoute(char ch) const {
+  return ParsingSettings().GetCloseQuotes()[static_cast<unsigned char>(ch)];
 }
 
 std::string StringParser::WordIdxToString(const WordIdx& word_idx) const {
-  return str_->substr(word_idx.start_, word_idx.len_);
+  return std::string(WordIdxToView(word_idx));
+}
+
+std::string_view StringParser::WordIdxToView(const WordIdx& word_idx) const {
+  return std::string_view(Str().data() + word_idx.start_, word_idx.len_);
 }
 
 }  // namespace TokenParser
@@ -17,8 +17,6 @@ Token::Token(float_type value) : Token(Type::kTypeFloat) { float_ = value; }
 
 Token::Token(id_type id) : Token(Type::kTypeId) { id_ = id; }
 
-Token::~Token() {}
-
 bool Token::operator==(const Token& other) const {
   if (GetType() != other.GetType()) return false;
 
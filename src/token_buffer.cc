@@ -0,0 +1,276 @@
+#include "../include/token_parser/token_buffer.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/token_parser/lexeme.h"
+#include "../include/token_parser/line_counter.h"
+#include "../include/token_parser/position.h"
+#include "../include/token_parser/token.h"
+
+namespace TokenParser {
+
+namespace {
+
+TokenBuffer::payload_type TokenToPayload(const Token& token) {
+  TokenBuffer::payload_type payload = 0;
+  switch (token.GetType()) {
+    case Token::Type::kTypeInt: {
+      Token::int_type value = token.GetInt();
+      std::memcpy(&payload, &value, sizeof(value));
+      break;
+    }
+    case Token::Type::kTypeUint:
+      payload = token.GetUint();
+      break;
+    case Token::Type::kTypeFloat: {
+      Token::float_type value = token.GetFloat();
+      std::memcpy(&payload, &value, sizeof(value));
+      break;
+    }
+    case Token::Type::kTypeId: {
+      Token::id_type value = token.GetId();
+      std::memcpy(&payload, &value, sizeof(value));
+      break;
+    }
+    default:
+      break;
+  }
+  return payload;
+}
+
+Token PayloadToToken(Token::Type type, TokenBuffer::payload_type payload) {
+  switch (type) {
+    case Token::Type::kTypeInt: {
+      Token::int_type value;
+      std::memcpy(&value, &payload, sizeof(value));
+      return Token(value);
+    }
+    case Token::Type::kTypeUint:
+      return Token(Token::uint_type(payload));
+    case Token::Type::kTypeFloat: {
+      Token::float_type value;
+      std::memcpy(&value, &payload, sizeof(value));
+      return Token(value);
+    }
+    case Token::Type::kTypeId: {
+      Token::id_type value;
+      std::memcpy(&value, &payload, sizeof(value));
+      return Token(value);
+    }
+    default:
+      break;
+  }
+  return Token(Token::Type::kTypeNull);
+}
+
+}  // namespace
+
+TokenBuffer::ConstIterator::ConstIterator(const TokenBuffer* buffer,
+                                          size_type i)
+    : buffer_(buffer), i_(i) {}
+
+Token TokenBuffer::ConstIterator::operator*() const {
+  return buffer_->GetToken(i_);
+}
+
+TokenBuffer::ConstIterator& TokenBuffer::ConstIterator::operator++() {
+  ++i_;
+  return *this;
+}
+
+TokenBuffer::ConstIterator TokenBuffer::ConstIterator::operator++(int) {
+  ConstIterator old = *this;
+  ++i_;
+  return old;
+}
+
+bool TokenBuffer::ConstIterator::operator==(
+    const ConstIterator& other) const {
+  return buffer_ == other.buffer_ && i_ == other.i_;
+}
+
+bool TokenBuffer::ConstIterator::operator!=(
+    const ConstIterator& other) const {
+  return !this->operator==(other);
+}
+
+TokenBuffer::TokenBuffer() : track_positions_(false) {}
+
+TokenBuffer::~TokenBuffer() {}
+
+void TokenBuffer::PushBack(const Lexeme& lexeme, size_type base) {
+  PushLexeme(lexeme, base + lexeme.GetStart());
+  if (track_positions_) {
+    lines_.push_back(size_type(0));
+    columns_.push_back(size_type(0));
+  }
+}
+
+void TokenBuffer::PushBack(const Lexeme& lexeme, const Position& position) {
+  PushLexeme(lexeme, position.GetOffset());
+  if (track_positions_) {
+    lines_.push_back(position.GetLine());
+    columns_.push_back(position.GetColumn());
+  }
+}
+
+void TokenBuffer::PushLexeme(const Lexeme& lexeme, size_type offset) {
+  const Token& token = lexeme.GetToken();
+  types_.push_back(token.GetType());
+  offsets_.push_back(offset);
+  lengths_.push_back(lexeme.GetText().length());
+
+  if (lexeme.IsWord()) {
+    std::string_view text = lexeme.GetText();
+    payloads_.push_back(payload_type(words_.size()));
+    words_.insert(words_.end(), text.begin(), text.end());
+  } else {
+    payloads_.push_back(TokenToPayload(token));
+  }
+}
+
+void TokenBuffer::CountPositions(size_type first, std::string_view str,
+                                 LineCounter& line_counter) {
+  lines_.resize(Size());
+  columns_.resize(Size());
+  line_counter.PositionsAt(str, offsets_.data() + first, Size() - first,
+                           lines_.data() + first, columns_.data() + first);
+}
+
+void TokenBuffer::Extend(size_type count, size_type words_length) {
+  size_type size = Size() + count;
+  types_.resize(size);
+  payloads_.resize(size);
+  offsets_.resize(size);
+  lengths_.resize(size);
+  if (track_positions_) {
+    lines_.resize(size);
+    columns_.resize(size);
+  }
+  words_.resize(words_.size() + words_length);
+}
+
+void TokenBuffer::SetLexeme(size_type i, const Lexeme& lexeme,
+                            size_type word_offset, size_type offset) {
+  const Token& token = lexeme.GetToken();
+  std::string_view text = lexeme.GetText();
+  types_[i] = token.GetType();
+  offsets_[i] = offset;
+  lengths_[i] = text.length();
+
+  if (lexeme.IsWord()) {
+    payloads_[i] = payload_type(word_offset);
+    std::memcpy(words_.data() + word_offset, text.data(), text.length());
+  } else {
+    payloads_[i] = TokenToPayload(token);
+  }
+}
+
+void TokenBuffer::SetLexeme(size_type i, const Lexeme& lexeme,
+                            size_type word_offset, const Position& position) {
+  SetLexeme(i, lexeme, word_offset, position.GetOffset());
+  if (track_positions_) {
+    lines_[i] = position.GetLine();
+    columns_[i] = position.GetColumn();
+  }
+}
+
+void TokenBuffer::SetTrackPositions(bool track) {
+  track_positions_ = track;
+  if (track) {
+    lines_.resize(Size(), size_type(0));
+    columns_.resize(Size(), size_type(0));
+  } else {
+    lines_.clear();
+    columns_.clear();
+  }
+}
+
+bool TokenBuffer::IsTrackingPositions() const { return track_positions_; }
+
+void TokenBuffer::Reserve(size_type count) {
+  types_.reserve(count);
+  payloads_.reserve(count);
+  offsets_.reserve(count);
+  lengths_.reserve(count);
+  if (track_positions_) {
+    lines_.reserve(count);
+    columns_.reserve(count);
+  }
+}
+
+void TokenBuffer::Clear() {
+  types_.clear();
+  payloads_.clear();
+  offsets_.clear();
+  lengths_.clear();
+  lines_.clear();
+  columns_.clear();
+  words_.clear();
+}
+
+TokenBuffer::size_type TokenBuffer::Size() const { return types_.size(); }
+
+bool TokenBuffer::Empty() const { return types_.empty(); }
+
+Token::Type TokenBuffer::GetType(size_type i) const { return types_[i]; }
+
+Token TokenBuffer::GetToken(size_type i) const {
+  return PayloadToToken(types_[i], payloads_[i]);
+}
+
+TokenBuffer::size_type TokenBuffer::GetOffset(size_type i) const {
+  return offsets_[i];
+}
+
+TokenBuffer::size_type TokenBuffer::GetLength(size_type i) const {
+  return lengths_[i];
+}
+
+Position TokenBuffer::GetPosition(size_type i) const {
+  return Position(offsets_[i], lines_[i], columns_[i]);
+}
+
+bool TokenBuffer::IsWord(size_type i) const {
+  return types_[i] == Token::Type::kTypeNull && lengths_[i] != size_type(0);
+}
+
+std::string_view TokenBuffer::GetWord(size_type i) const {
+  return std::string_view(words_.data() + payloads_[i], lengths_[i]);
+}
+
+const Token::Type* TokenBuffer::GetTypes() const { return types_.data(); }
+
+const TokenBuffer::payload_type* TokenBuffer::GetPayloads() const {
+  return payloads_.data();
+}
+
+const TokenBuffer::size_type* TokenBuffer::GetOffsets() const {
+  return offsets_.data();
+}
+
+const TokenBuffer::size_type* TokenBuffer::GetLengths() const {
+  return lengths_.data();
+}
+
+const TokenBuffer::size_type* TokenBuffer::GetLines() const {
+  return lines_.data();
+}
+
+const TokenBuffer::size_type* TokenBuffer::GetColumns() const {
+  return columns_.data();
+}
+
+TokenBuffer::ConstIterator TokenBuffer::begin() const {
+  return ConstIterator(this, size_type(0));
+}
+
+TokenBuffer::ConstIterator TokenBuffer::end() const {
+  return ConstIterator(this, Size());
+}
+
+}  // namespace TokenParser
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../include/token_parser/async_file_streambuf.h"
+#include "../include/token_parser/file_parser.h"
+#include "../include/token_parser/stream_parser.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#endif
+
+using TokenParser::AsyncFileStreambuf;
+using TokenParser::FileParser;
+
+TEST(AsyncFileStreambuf, SameAsFile) {
+  std::string str;
+  for (int i = 0; i < 5000; ++i) str += std::to_string(i * 7919 % 1000) + " ";
+
+  const std::string kTmpFilename = ".tmp_token_parser_test_async_file.txt";
+  const std::string kEmptyFilename = ".tmp_token_parser_test_async_empty.txt";
+  std::ofstream(kTmpFilename) << str;
+  std::ofstream(kEmptyFilename).close();
+
+  AsyncFileStreambuf buff;
+  ASSERT_FALSE(buff.IsOpen());
+  std::istream stream(&buff);
+  ASSERT_EQ(stream.get(), std::char_traits<char>::eof());
+
+  for (AsyncFileStreambuf::Engine engine :
+       {AsyncFileStreambuf::kEngineUring, AsyncFileStreambuf::kEnginePread}) {
+    for (bool direct_io : {false, true}) {
+      for (std::size_t buff_size : {1, 7, 4096, 1 << 16}) {
+        for (std::size_t count : {0, 2, 5}) {
+          ASSERT_TRUE(
+              buff.Open(kTmpFilename, buff_size, count, direct_io, engine));
+          ASSERT_TRUE(buff.IsOpen());
+          ASSERT_EQ(buff.GetEngine() == AsyncFileStreambuf::kEngineUring,
+                    engine == AsyncFileStreambuf::kEngineUring &&
+                        AsyncFileStreambuf::IsUringSupported());
+          stream.clear();
+
+          std::string res((std::istreambuf_iterator<char>(stream)),
+                          std::istreambuf_iterator<char>());
+          ASSERT_EQ(res, str) << engine << " " << direct_io << " "
+                              << buff_size << " " << count;
+        }
+      }
+
+      ASSERT_TRUE(buff.Open(kEmptyFilename, 16, 2, direct_io, engine));
+      stream.clear();
+      ASSERT_EQ(stream.get(), std::char_traits<char>::eof());
+    }
+  }
+
+  // Closed while the reads are queued.
+  ASSERT_TRUE(buff.Open(kTmpFilename, 16, 4));
+  stream.clear();
+  char chars[10];
+  stream.read(chars, 10);
+  ASSERT_EQ(std::string(chars, 10), str.substr(0, 10));
+  buff.Close();
+  ASSERT_FALSE(buff.IsOpen());
+  ASSERT_EQ(stream.get(), std::char_traits<char>::eof());
+
+  ASSERT_FALSE(buff.Open(".tmp_token_parser_test_no_such_file.txt", 16, 2));
+  ASSERT_FALSE(buff.Open(".", 16, 2));
+  ASSERT_FALSE(buff.IsOpen());
+
+  std::remove(kTmpFilename.c_str());
+  std::remove(kEmptyFilename.c_str());
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST(AsyncFileStreambuf, ReadError) {
+  const std::string kTmpFilename = ".tmp_token_parser_test_async_error.txt";
+  std::ofstream(kTmpFilename) << "word 12 word 34";
+
+  AsyncFileStreambuf buff;
+  std::istream stream(&buff);
+  for (AsyncFileStreambuf::Engine engine :
+       {AsyncFileStreambuf::kEngineUring, AsyncFileStreambuf::kEnginePread}) {
+    // The reads of a descriptor opened for writing fail with EBADF.
+    ASSERT_TRUE(buff.Open(::open(kTmpFilename.c_str(), O_WRONLY), 4, 2,
+                          engine));
+    stream.clear();
+    char chars[4];
+    stream.read(chars, 4);
+    ASSERT_TRUE(stream.bad()) << engine;
+    ASSERT_FALSE(stream.eof()) << engine;
+    ASSERT_EQ(buff.GetError(), EBADF) << engine;
+    ASSERT_FALSE(buff.IsOpen());
+
+    // The parser stops at the error instead of waiting for eof.
+    ASSERT_TRUE(buff.Open(::open(kTmpFilename.c_str(), O_WRONLY), 4, 2,
+                          engine));
+    stream.clear();
+    TokenParser::StreamParser<char> parser(&stream);
+    ASSERT_EQ(parser.NextWord(), "");
+    ASSERT_TRUE(parser.IsEnd());
+    ASSERT_TRUE(stream.bad());
+  }
+
+  ASSERT_TRUE(buff.Open(::open(kTmpFilename.c_str(), O_RDONLY), 4, 2));
+  ASSERT_EQ(buff.GetError(), 0);
+  stream.clear();
+  std::string res((std::istreambuf_iterator<char>(stream)),
+                  std::istreambuf_iterator<char>());
+  ASSERT_EQ(res, "word 12 word 34");
+  ASSERT_FALSE(buff.Open(-1, 4, 2));
+
+  std::remove(kTmpFilename.c_str());
+}
+#endif
+
+TEST(FileParserAsync, SameAsStream) {
+  std::string str;
+  for (int i = 0; i < 3000; ++i) {
+    str += "word" + std::to_string(i) + (i % 3 ? " " : "\n");
+    str += std::to_string(i) + (i % 7 ? " " : " 'qouted\n word' ");
+  }
+
+  const std::string kTmpFilename = ".tmp_token_parser_test_async.txt";
+  std::ofstream file(kTmpFilename);
+  file << str;
+  file.close();
+
+  TokenParser::Settings settings;
+  settings.SetWordDelim(settings.GetWordDelimChars() + "'");
+  settings.SetWordMaySurrondedByQoutes(true);
+  FileParser stream_parser(settings);
+  FileParser parser(settings);
+  parser.SetBackend(FileParser::kBackendAsync);
+  std::vector<std::string> expected;
+  for (std::size_t buff_size : {1, 7, 4096, 1 << 16}) {
+    for (bool direct_io : {false, true}) {
+      // Direct reads take blocks of the aligned size, so does the stream
+      // backend to get the same blocks.
+      std::size_t size = direct_io ? (buff_size + 4095) / 4096 * 4096
+                                   : buff_size;
+      stream_parser.SetBuffSize(size);
+      stream_parser.SetFile(kTmpFilename);
+      expected.clear();
+      while (!stream_parser.IsEnd())
+        expected.push_back(stream_parser.NextWord());
+
+      for (std::size_t count : {2, 4}) {
+        parser.SetBuffSize(size);
+        parser.SetReadAheadCount(count);
+        parser.SetDirectIo(direct_io);
+        parser.SetFile(kTmpFilename);
+        std::vector<std::string> res;
+        while (!parser.IsEnd()) res.push_back(parser.NextWord());
+        ASSERT_EQ(res, expected) << buff_size << " " << direct_io << " "
+                                 << count;
+      }
+    }
+  }
+
+  // Stopped in the middle of the file.
+  parser.SetBuffSize(16);
+  parser.SetDirectIo(false);
+  parser.SetFile(kTmpFilename);
+  ASSERT_EQ(parser.NextWord(), expected[0]);
+  parser.Reset();
+  ASSERT_TRUE(parser.IsEnd());
+  parser.SetFile(kTmpFilename);
+  ASSERT_EQ(parser.NextWord(), expected[0]);
+
+  parser.SetFile(".tmp_token_parser_test_no_such_file.txt");
+  ASSERT_TRUE(parser.IsEnd());
+
+  std::remove(kTmpFilename.c_str());
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../include/token_parser/char_set.h"
+
+using TokenParser::CharSet;
+
+TEST(CharSet, Common) {
+  CharSet set(" \t\n");
+  std::string str = "  \t\nword \n";
+  const char* first = str.data();
+  const char* last = str.data() + str.size();
+
+  ASSERT_TRUE(set.Contains(' '));
+  ASSERT_FALSE(set.Contains('w'));
+  ASSERT_EQ(set.FindNot(first, last) - first, 4);
+  ASSERT_EQ(set.Find(first + 4, last) - first, 8);
+  ASSERT_EQ(set.Find(first + 9, last) - first, 9);
+  ASSERT_EQ(set.FindNot(first + 8, last), last);
+  ASSERT_EQ(set.Find(first, first), first);
+
+  CharSet empty;
+  ASSERT_EQ(empty.Find(first, last), last);
+  ASSERT_EQ(empty.FindNot(first, last), first);
+}
+
+TEST(CharSet, KernelsSameAsScalar) {
+  std::vector<std::string> sets = {
+      "",  " ", "\n \f\r\t\v", "\n \f\r\t\v;(){}=", "\n \f\r\t\v#;(){}='\"<>",
+      "\xff\x80\x7f"};
+  std::vector<CharSet::Kernel> kernels = {CharSet::kKernelSse2,
+                                          CharSet::kKernelAvx2};
+
+  std::string str;
+  const char kAlphabet[] = " \t\n;=ab\xff\x80{";
+  for (int i = 0; i < 3000; ++i)
+    str.push_back(kAlphabet[(i * 7 + i / 13 + (i / 61) * 5) % 11]);
+  str += std::string(100, ' ') + std::string(100, 'a') + "  ";
+
+  for (const std::string& chars : sets) {
+    CharSet set(chars);
+    for (CharSet::Kernel kernel : kernels) {
+      if (!CharSet::IsKernelSupported(kernel)) continue;
+
+      for (std::string::size_type i = 0; i < str.size(); ++i) {
+        for (std::string::size_type len : {0, 1, 15, 16, 17, 33, 64, 300}) {
+          const char* first = str.data() + i;
+          const char* last = str.data() + std::min(str.size(), i + len);
+          ASSERT_EQ(set.Find(first, last, kernel),
+                    set.Find(first, last, CharSet::kKernelScalar));
+          ASSERT_EQ(set.FindNot(first, last, kernel),
+                    set.FindNot(first, last, CharSet::kKernelScalar));
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+#include "../include/token_parser/id_index.h"
+
+using TokenParser::IdIndex;
+
+TEST(IdIndex, Find) {
+  IdIndex index;
+  std::string_view text;
+  ASSERT_TRUE(index.Empty());
+  ASSERT_FALSE(index.Find(0, text));
+
+  IdIndex::TokenIds dense_ids;
+  for (int i = 0; i < 100; i += 2) dense_ids.insert({i, std::to_string(i)});
+  dense_ids.insert({1, ""});
+  index.Build(dense_ids);
+  ASSERT_TRUE(index.IsDense());
+  for (const auto& token_id : dense_ids) {
+    ASSERT_TRUE(index.Find(token_id.first, text));
+    ASSERT_EQ(text, token_id.second);
+  }
+  ASSERT_FALSE(index.Find(3, text));
+  ASSERT_FALSE(index.Find(-1, text));
+  ASSERT_FALSE(index.Find(1000, text));
+
+  IdIndex::TokenIds sparse_ids = {
+      {-5, "minus"}, {7, "seven"}, {1 << 20, "big"}, {1 << 30, "bigger"}};
+  index.Build(sparse_ids);
+  ASSERT_FALSE(index.IsDense());
+  for (const auto& token_id : sparse_ids) {
+    ASSERT_TRUE(index.Find(token_id.first, text));
+    ASSERT_EQ(text, token_id.second);
+  }
+  ASSERT_FALSE(index.Find(0, text));
+  ASSERT_FALSE(index.Find(8, text));
+  ASSERT_FALSE(index.Find((1 << 30) + 1, text));
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "../include/token_parser/keyword_hash.h"
+
+using TokenParser::KeywordHash;
+
+TEST(KeywordHash, Find) {
+  KeywordHash hash;
+  KeywordHash::id_type id = -1;
+  ASSERT_TRUE(hash.Empty());
+  ASSERT_FALSE(hash.Find("", id));
+
+  KeywordHash::TokenIds token_ids;
+  for (int i = 0; i < 1000; ++i)
+    token_ids.insert({i, "kw" + std::to_string(i)});
+  token_ids.insert({1000, "'quoted id'"});
+  token_ids.insert({1001, "kw7"});
+  token_ids.insert({1002, ""});
+  hash.Build(token_ids);
+  ASSERT_FALSE(hash.Empty());
+
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_TRUE(hash.Find("kw" + std::to_string(i), id));
+    ASSERT_EQ(id, i);
+  }
+  ASSERT_TRUE(hash.Find("'quoted id'", id));
+  ASSERT_EQ(id, 1000);
+  ASSERT_TRUE(hash.Find("", id));
+  ASSERT_EQ(id, 1002);
+  ASSERT_FALSE(hash.Find("kw", id));
+  ASSERT_FALSE(hash.Find("kw1000", id));
+  ASSERT_FALSE(hash.Find("'quoted id", id));
+
+  hash.Build(KeywordHash::TokenIds());
+  ASSERT_TRUE(hash.Empty());
+  ASSERT_FALSE(hash.Find("kw1", id));
+}
@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "../include/token_parser/file_parser.h"
 #include "../include/token_parser/stream_parser.h"
@@ -92,6 +95,36 @@ void TokenParserTestTyped<TokenParser::FileParser>::EndupParser(
   std::remove(filename.c_str());
 }
 
+/// @brief FileParser that maps files to memory.
+class MmapFileParser : public TokenParser::FileParser {
+ public:
+  MmapFileParser() { SetBackend(kBackendMmap); }
+  MmapFileParser(const TokenParser::Settings& settings)
+      : TokenParser::FileParser(settings) {
+    SetBackend(kBackendMmap);
+  }
+};
+
+template <>
+void* TokenParserTestTyped<MmapFileParser>::SetupParser(
+    MmapFileParser& parser, const std::string& str) {
+  const std::string& filename = TokenParserTestTyped::kTmpFilename_;
+  std::ofstream file(filename);
+  file << str;
+  file.close();
+  parser.SetFile(filename);
+  return nullptr;
+}
+
+template <>
+void TokenParserTestTyped<MmapFileParser>::EndupParser(MmapFileParser& parser,
+                                                       void* mem) {
+  (void)parser;
+  (void)mem;
+  const std::string& filename = TokenParserTestTyped::kTmpFilename_;
+  std::remove(filename.c_str());
+}
+
 template <typename T>
 class NextTokenNoStr : public TokenParserTestTyped<T> {};
 template <typename T>
@@ -106,10 +139,16 @@ template <typename T>
 class Delims : public TokenParserTestTyped<T> {};
 template <typename T>
 class NextThisId : public TokenParserTestTyped<T> {};
+template <typename T>
+class LongestMatch : public TokenParserTestTyped<T> {};
+template <typename T>
+class NextWordView : public TokenParserTestTyped<T> {};
+template <typename T>
+class NextBatch : public TokenParserTestTyped<T> {};
 
 using TokenParserTestTypedTypes =
     testing::Types<TokenParser::StringParser, TokenParser::StreamParser<char>,
-                   TokenParser::FileParser>;
+                   TokenParser::FileParser, MmapFileParser>;
 
 TYPED_TEST_SUITE(NextTokenNoStr, TokenParserTestTypedTypes);
 TYPED_TEST_SUITE(NextTokenEndLen, TokenParserTestTypedTypes);
@@ -118,6 +157,9 @@ TYPED_TEST_SUITE(IsEnd, TokenParserTestTypedTypes);
 TYPED_TEST_SUITE(NextWord, TokenParserTestTypedTypes);
 TYPED_TEST_SUITE(Delims, TokenParserTestTypedTypes);
 TYPED_TEST_SUITE(NextThisId, TokenParserTestTypedTypes);
+TYPED_TEST_SUITE(LongestMatch, TokenParserTestTypedTypes);
+TYPED_TEST_SUITE(NextWordView, TokenParserTestTypedTypes);
+TYPED_TEST_SUITE(NextBatch, TokenParserTestTypedTypes);
 
 TYPED_TEST(NextTokenNoStr, NextWord) {
   TypeParam parser;
@@ -125,6 +167,11 @@ TYPED_TEST(NextTokenNoStr, NextWord) {
   ASSERT_EQ("", str);
 }
 
+TYPED_TEST(NextTokenNoStr, NextWordView) {
+  TypeParam parser;
+  ASSERT_TRUE(parser.NextWordView().empty());
+}
+
 TYPED_TEST(NextTokenNoStr, NextInt) {
   TypeParam parser;
   TokenParser::Token tok = parser.NextInt();
@@ -259,7 +306,9 @@ TEST(IsEnd, Common) {
   parser.SetI(41421);
   ASSERT_TRUE(parser.IsEnd());
   parser.SetI(12);
-  parser.GetSettings().SetSpaceChars(" \t\ni");
+  TokenParser::Settings settings = parser.GetSettings();
+  settings.SetSpaceChars(" \t\ni");
+  parser.SetSettings(std::move(settings));
   ASSERT_TRUE(parser.IsEnd());
 }
 
@@ -353,7 +402,8 @@ TEST(NextThisId, Common) {
   parser.SetI(0);
   ASSERT_EQ(parser.NextThisId(TokenParser::Token::id_type(0)).GetId(),
             TokenParser::Token::id_type(0));
-  parser.GetSettings().SetTokenIdIsFullWord(false);
+  settings.SetTokenIdIsFullWord(false);
+  parser.SetSettings(settings);
   parser.SetI(0);
   ASSERT_EQ(parser.NextThisId(TokenParser::Token::id_type(1)).GetId(),
             TokenParser::Token::id_type(1));
@@ -361,3 +411,733 @@ TEST(NextThisId, Common) {
   ASSERT_EQ(parser.NextThisId(TokenParser::Token::id_type(0)).GetId(),
             TokenParser::Token::id_type(0));
 }
+
+TEST(NextId, SmallestIdWins) {
+  TokenParser::Settings::TokenIds tokens = {
+      {0, "int32_t"}, {1, "int"}, {2, "in"}, {3, "in"}};
+  TokenParser::Settings settings;
+  settings.SetTokenIds(tokens);
+  settings.SetTokenIdIsFullWord(false);
+
+  std::string parsing_str = "int32_t int in";
+  TokenParser::StringParser parser(settings, &parsing_str);
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(0));
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(1));
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(2));
+  ASSERT_TRUE(parser.IsEnd());
+
+  tokens = {{0, "in"}, {1, "int"}, {2, "int32_t"}};
+  settings.SetTokenIds(tokens);
+  parser.SetSettings(settings);
+  parser.SetI(0);
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(0));
+
+  settings.SetTokenIdIsFullWord(true);
+  parser.SetSettings(settings);
+  parser.SetI(0);
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(2));
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(1));
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(0));
+}
+
+TEST(NextId, WholeWordSameAsNextThisIdInOrder) {
+  // No id has a word delim char inside, so full word ids are taken by the
+  // whole word.
+  TokenParser::Settings::TokenIds tokens;
+  for (int i = 0; i < 300; ++i) {
+    std::string word;
+    for (int j = i; j > 0; j /= 2) word.push_back("ab"[j % 2]);
+    tokens.insert({(i * 7919) % 1009, word});
+  }
+  tokens.insert({1009, "="});
+  tokens.insert({1010, "b"});
+
+  std::string parsing_str;
+  for (int i = 0; i < 500; ++i) parsing_str.push_back("ab= \n"[(i * i) % 5]);
+
+  TokenParser::Settings settings;
+  settings.SetTokenIds(tokens);
+  settings.SetWordDelim(settings.GetWordDelimChars() + "=");
+  TokenParser::StringParser parser(settings, &parsing_str);
+  ASSERT_TRUE(parser.GetCompiledSettings()->GetIdIsWord());
+
+  for (TokenParser::StringParser::size_type i = 0; i < parsing_str.size();
+       ++i) {
+    TokenParser::Token expected;
+    TokenParser::StringParser::size_type expected_i = i;
+    for (const auto& token_id : tokens) {
+      parser.SetI(i);
+      expected = parser.NextThisId(token_id.first);
+      expected_i = parser.GetI();
+      if (!expected.IsNull()) break;
+    }
+
+    parser.SetI(i);
+    ASSERT_EQ(parser.NextId(), expected) << i;
+    if (!expected.IsNull()) {
+      ASSERT_EQ(parser.GetI(), expected_i);
+    }
+  }
+
+  settings.SetTokenIds({{0, "a"}, {1, "a=b"}});
+  ASSERT_FALSE(TokenParser::CompiledSettings(settings).GetIdIsWord());
+  settings.SetTokenIds({{0, "a"}, {1, "=b"}});
+  ASSERT_TRUE(TokenParser::CompiledSettings(settings).GetIdIsWord());
+}
+
+TEST(NextId, SameAsNextThisIdInOrder) {
+  TokenParser::Settings::TokenIds tokens;
+  for (int i = 0; i < 600; ++i) {
+    std::string word;
+    for (int j = i; j > 0; j /= 3) word.push_back("ab="[j % 3]);
+    tokens.insert({(i * 7919) % 1009, word});
+  }
+
+  std::string parsing_str;
+  for (int i = 0; i < 500; ++i) parsing_str.push_back("ab= \n"[(i * i) % 5]);
+
+  for (bool full_word : {true, false}) {
+    TokenParser::Settings settings;
+    settings.SetTokenIds(tokens);
+    settings.SetWordDelim(settings.GetWordDelimChars() + "=");
+    settings.SetTokenIdIsFullWord(full_word);
+    TokenParser::StringParser parser(settings, &parsing_str);
+
+    for (TokenParser::StringParser::size_type i = 0; i < parsing_str.size();
+         ++i) {
+      TokenParser::Token expected;
+      TokenParser::StringParser::size_type expected_i = i;
+      for (const auto& token_id : tokens) {
+        parser.SetI(i);
+        expected = parser.NextThisId(token_id.first);
+        expected_i = parser.GetI();
+        if (!expected.IsNull()) break;
+      }
+
+      parser.SetI(i);
+      ASSERT_EQ(parser.NextId(), expected);
+      if (!expected.IsNull()) {
+        ASSERT_EQ(parser.GetI(), expected_i);
+      }
+    }
+  }
+}
+
+TYPED_TEST(LongestMatch, Common) {
+  TokenParser::Settings::TokenIds tokens = {
+      {0, "<"}, {1, "<="}, {2, "="}, {3, "int"}, {4, "int32_t"}, {5, "in"}};
+  TokenParser::Settings settings;
+  settings.SetTokenIds(tokens);
+  settings.SetWordDelim(settings.GetWordDelimChars() + "<=");
+  settings.SetTokenIdIsFullWord(false);
+  settings.SetTokenIdLongestMatch(true);
+
+  std::string parsing_str = "<=< = int32_tint in int3";
+  TypeParam parser(settings);
+  void* mem = LongestMatch<TypeParam>::SetupParser(parser, parsing_str);
+
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(1));
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(0));
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(2));
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(4));
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(3));
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(5));
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(3));
+  ASSERT_EQ(parser.NextUint().GetUint(), TokenParser::Token::uint_type(3));
+  ASSERT_TRUE(parser.IsEnd());
+  LongestMatch<TypeParam>::EndupParser(parser, mem);
+}
+
+TYPED_TEST(LongestMatch, FullWord) {
+  TokenParser::Settings::TokenIds tokens = {
+      {0, "<"}, {1, "<="}, {2, "int"}, {3, "int32_t"}};
+  TokenParser::Settings settings;
+  settings.SetTokenIds(tokens);
+  settings.SetWordDelim(settings.GetWordDelimChars() + "<=");
+  settings.SetTokenIdLongestMatch(true);
+
+  std::string parsing_str = "<= int32_t int int32_tt";
+  TypeParam parser(settings);
+  void* mem = LongestMatch<TypeParam>::SetupParser(parser, parsing_str);
+
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(1));
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(3));
+  ASSERT_EQ(parser.NextId().GetId(), TokenParser::Token::id_type(2));
+  ASSERT_TRUE(parser.NextId().IsNull());
+  ASSERT_EQ(parser.NextWord(), "int32_tt");
+  LongestMatch<TypeParam>::EndupParser(parser, mem);
+}
+
+TYPED_TEST(NextWordView, SameAsNextWord) {
+  std::string parsing_str =
+      "word 'qouted\n word' \n\n 12=word=\"qouted ' word\"'not closed\n";
+  TokenParser::Settings settings;
+  settings.SetWordDelim(settings.GetWordDelimChars() + "='\"");
+  settings.SetWordMaySurrondedByQoutes(true);
+
+  TypeParam words_parser(settings);
+  TypeParam views_parser(settings);
+  void* words_mem =
+      NextWordView<TypeParam>::SetupParser(words_parser, parsing_str);
+  std::vector<std::string> words;
+  while (!words_parser.IsEnd()) words.push_back(words_parser.NextWord());
+  NextWordView<TypeParam>::EndupParser(words_parser, words_mem);
+
+  void* views_mem =
+      NextWordView<TypeParam>::SetupParser(views_parser, parsing_str);
+  std::vector<std::string> views;
+  while (!views_parser.IsEnd())
+    views.push_back(std::string(views_parser.NextWordView()));
+  NextWordView<TypeParam>::EndupParser(views_parser, views_mem);
+
+  std::vector<std::string> expected = {
+      "word", "'qouted\n word'", "12", "=", "word", "=",
+      "\"qouted ' word\"", "'not closed\n"};
+  ASSERT_EQ(words, expected);
+  ASSERT_EQ(views, expected);
+}
+
+TYPED_TEST(NextBatch, Classified) {
+  std::string parsing_str =
+      "int x=-12; 'qouted\n word' 3.5e2 .5 7 +8 inf e5 int32_t 12ab\n";
+  TokenParser::Settings settings;
+  settings.SetTokenIds({{0, "int"}, {1, "="}, {2, ";"}});
+  settings.SetWordDelim(settings.GetWordDelimChars() + "=;'");
+  settings.SetWordMaySurrondedByQoutes(true);
+
+  std::vector<TokenParser::Token> tokens = {
+      TokenParser::Token(0),
+      TokenParser::Token(),
+      TokenParser::Token(1),
+      TokenParser::Token(TokenParser::Token::int_type(-12)),
+      TokenParser::Token(2),
+      TokenParser::Token(),
+      TokenParser::Token(TokenParser::Token::float_type(350)),
+      TokenParser::Token(TokenParser::Token::float_type(0.5)),
+      TokenParser::Token(TokenParser::Token::uint_type(7)),
+      TokenParser::Token(TokenParser::Token::uint_type(8)),
+      TokenParser::Token(),
+      TokenParser::Token(),
+      TokenParser::Token(),
+      TokenParser::Token(TokenParser::Token::uint_type(12)),
+      TokenParser::Token()};
+  std::vector<std::string> texts = {
+      "int", "x",  "=",   "-12", ";",  "'qouted\n word'", "3.5e2", ".5",
+      "7",   "+8", "inf", "e5",  "int32_t", "12", "ab"};
+
+  for (std::size_t batch_size : {1, 2, 64}) {
+    TypeParam parser(settings);
+    void* mem = NextBatch<TypeParam>::SetupParser(parser, parsing_str);
+    std::vector<TokenParser::Lexeme> lexemes(batch_size);
+    std::vector<TokenParser::Token> res_tokens;
+    std::vector<std::string> res_texts;
+    while (true) {
+      std::size_t n = parser.NextBatch(lexemes.data(), lexemes.size());
+      if (n == 0) break;
+      for (std::size_t k = 0; k < n; ++k) {
+        ASSERT_FALSE(lexemes[k].IsEnd());
+        ASSERT_EQ(lexemes[k].IsToken(), !lexemes[k].IsWord());
+        ASSERT_EQ(parser.GetView().substr(lexemes[k].GetStart(),
+                                          lexemes[k].GetText().length()),
+                  lexemes[k].GetText());
+        res_tokens.push_back(lexemes[k].GetToken());
+        res_texts.push_back(std::string(lexemes[k].GetText()));
+      }
+    }
+    ASSERT_TRUE(parser.IsEnd());
+    NextBatch<TypeParam>::EndupParser(parser, mem);
+
+    ASSERT_EQ(res_tokens, tokens) << batch_size;
+    ASSERT_EQ(res_texts, texts) << batch_size;
+  }
+}
+
+TYPED_TEST(NextBatch, NextAnySameAsNextBatch) {
+  std::string parsing_str;
+  for (int i = 0; i < 300; ++i) {
+    parsing_str += "int a" + std::to_string(i) + "=" + std::to_string(i - 50);
+    parsing_str += i % 5 ? "; " : "; 'qouted\n' ";
+    parsing_str += std::to_string(i) + ".25e1\n";
+  }
+  TokenParser::Settings settings;
+  settings.SetTokenIds({{0, "int"}, {1, "="}, {2, ";"}});
+  settings.SetWordDelim(settings.GetWordDelimChars() + "=;'");
+  settings.SetWordMaySurrondedByQoutes(true);
+
+  TypeParam batch_parser(settings);
+  void* batch_mem = NextBatch<TypeParam>::SetupParser(batch_parser,
+                                                      parsing_str);
+  std::vector<TokenParser::Lexeme> lexemes(16);
+  std::vector<std::pair<TokenParser::Token, std::string>> expected;
+  while (std::size_t n = batch_parser.NextBatch(lexemes.data(), 16)) {
+    for (std::size_t k = 0; k < n; ++k)
+      expected.push_back({lexemes[k].GetToken(),
+                          std::string(lexemes[k].GetText())});
+  }
+  NextBatch<TypeParam>::EndupParser(batch_parser, batch_mem);
+
+  TypeParam parser(settings);
+  void* mem = NextBatch<TypeParam>::SetupParser(parser, parsing_str);
+  std::vector<std::pair<TokenParser::Token, std::string>> res;
+  for (auto lexeme = parser.NextAny(); !lexeme.IsEnd();
+       lexeme = parser.NextAny())
+    res.push_back({lexeme.GetToken(), std::string(lexeme.GetText())});
+  ASSERT_TRUE(parser.NextAny().IsEnd());
+  NextBatch<TypeParam>::EndupParser(parser, mem);
+
+  ASSERT_EQ(expected.size(), std::size_t(300 * 6 + 60));
+  ASSERT_EQ(res, expected);
+}
+
+TEST(StringParserView, NumbersNotReadAfterEnd) {
+  std::string buff = "12 -34 5.5 nan( 77";
+  TokenParser::StringParser parser(std::string_view(buff.data(), 5));
+  ASSERT_EQ(parser.GetStr(), nullptr);
+  ASSERT_EQ(parser.GetView(), "12 -3");
+  ASSERT_EQ(parser.NextUint().GetUint(), TokenParser::Token::uint_type(12));
+  ASSERT_EQ(parser.NextInt().GetInt(), TokenParser::Token::int_type(-3));
+  ASSERT_TRUE(parser.IsEnd());
+
+  parser.SetStr(buff.data() + 7, 3);
+  ASSERT_EQ(parser.NextFloat().GetFloat(), TokenParser::Token::float_type(5.5));
+  ASSERT_TRUE(parser.IsEnd());
+
+  parser.SetStr(buff.data() + 11, 4);
+  ASSERT_TRUE(std::isnan(parser.NextFloat().GetFloat()));
+  ASSERT_EQ(parser.GetI(), TokenParser::StringParser::size_type(3));
+
+  std::string long_number = std::string(100, '0') + "17";
+  parser.SetStr(std::string_view(long_number));
+  ASSERT_EQ(parser.NextUint().GetUint(), TokenParser::Token::uint_type(17));
+  ASSERT_TRUE(parser.IsEnd());
+
+  parser.SetStr(std::string_view());
+  ASSERT_TRUE(parser.IsEnd());
+  ASSERT_TRUE(parser.NextInt().IsNull());
+}
+
+TEST(StringParserView, NumberCopyStopsAtNumber) {
+  // Out of range numbers and words like "nine" are given to strto*, they get
+  // a copy of the number chars only, not of the rest of the view.
+  std::string buff;
+  std::size_t expected_numbers = 0;
+  std::size_t expected_words = 0;
+  for (int i = 0; buff.size() < (1 << 20); ++i) {
+    buff += i % 2 ? "1e999 nine " : "  99999999999999999999 ";
+    ++expected_numbers;
+    if (i % 2) ++expected_words;
+  }
+  TokenParser::StringParser parser((std::string_view(buff)));
+  std::size_t numbers = 0;
+  std::size_t words = 0;
+  while (!parser.IsEnd()) {
+    TokenParser::Token token = parser.NextFloat();
+    if (token.IsNull()) {
+      ASSERT_EQ(parser.NextWord(), "nine");
+      ++words;
+      continue;
+    }
+    ASSERT_TRUE(std::isinf(token.GetFloat()) ||
+                token.GetFloat() == TokenParser::Token::float_type(1e20));
+    ++numbers;
+  }
+  ASSERT_EQ(numbers, expected_numbers);
+  ASSERT_EQ(words, expected_words);
+}
+
+TEST(Numbers, SameAsStrto) {
+  std::vector<std::string> strs = {
+      "0", "-0", "+0", "+-1", "-+1", "- 1", "\t\v 12", "12abc", "0x1A", "0X",
+      "9223372036854775807", "9223372036854775808", "-9223372036854775808",
+      "-9223372036854775809", "18446744073709551615", "18446744073709551616",
+      "-18446744073709551615", "-18446744073709551616",
+      "99999999999999999999999", "-99999999999999999999999", "00000000007",
+      ".5", "-.5", "5.", "1e", "1e+", "1e-3", "1E3x", "1.5e308", "1e309",
+      "-1e309", "1e-320", "1e-400", "4.4e+3", "0.1", "-134.1", "3.3;",
+      "0x1p3", "0x1.8P-1", "-0x", "inf", "-INF", "infinity", "info", "nan",
+      "-nan(abc_1)", "nan(", "nanx", "n", "i", ".", "-.", "+", "", "e5",
+      "123456789012345678901234567890e-10", "2.2250738585072014e-308",
+      "1.7976931348623157e308", "0.30000000000000004", "1_000"};
+  for (int i = 1; i < 2000; ++i) {
+    std::string digits = std::to_string(i * 2654435761u);
+    std::string str = (i % 3 ? "" : "-") + digits.substr(0, i % 11 + 1);
+    if (i % 2) str += "." + digits.substr(i % 5);
+    if (i % 7 == 0) str += "e" + std::to_string(i % 40 - 20);
+    strs.push_back(str);
+  }
+
+  for (const std::string& str : strs) {
+    // The chars after the view are not a part of the number.
+    std::string buff = str + "7";
+    TokenParser::StringParser parser(std::string_view(buff.data(), str.size()));
+    char* end;
+
+    long long int_expected = std::strtoll(str.c_str(), &end, 10);
+    TokenParser::Token token = parser.NextInt();
+    if (end == str.c_str()) {
+      ASSERT_TRUE(token.IsNull()) << str;
+    } else {
+      ASSERT_EQ(token.GetInt(), int_expected) << str;
+      ASSERT_EQ(parser.GetI(), end - str.c_str()) << str;
+    }
+
+    parser.SetI(0);
+    unsigned long long uint_expected = std::strtoull(str.c_str(), &end, 10);
+    token = parser.NextUint();
+    if (end == str.c_str()) {
+      ASSERT_TRUE(token.IsNull()) << str;
+    } else {
+      ASSERT_EQ(token.GetUint(), uint_expected) << str;
+      ASSERT_EQ(parser.GetI(), end - str.c_str()) << str;
+    }
+
+    // strtod is correctly rounded, strtold rounded to double may be one ulp
+    // away from it (double rounding).
+    parser.SetI(0);
+    double float_expected = std::strtod(str.c_str(), &end);
+    token = parser.NextFloat();
+    if (end == str.c_str()) {
+      ASSERT_TRUE(token.IsNull()) << str;
+    } else if (std::isnan(float_expected)) {
+      ASSERT_TRUE(std::isnan(token.GetFloat())) << str;
+      ASSERT_EQ(std::signbit(token.GetFloat()), std::signbit(float_expected));
+    } else {
+      ASSERT_EQ(token.GetFloat(), float_expected) << str;
+      ASSERT_EQ(std::signbit(token.GetFloat()), std::signbit(float_expected));
+      ASSERT_EQ(parser.GetI(), end - str.c_str()) << str;
+    }
+  }
+}
+
+TEST(FileParserMmap, Mapped) {
+  const std::string kTmpFilename = ".tmp_token_parser_test_mmap.txt";
+  std::ofstream file(kTmpFilename);
+  file << "word 12";
+  file.close();
+
+  TokenParser::FileParser parser;
+  parser.SetBackend(TokenParser::FileParser::kBackendMmap);
+  parser.SetFile(kTmpFilename);
+  ASSERT_TRUE(parser.IsMapped());
+  ASSERT_EQ(parser.GetView(), "word 12");
+  ASSERT_EQ(parser.NextWord(), "word");
+  ASSERT_EQ(parser.NextInt().GetInt(), 12);
+  ASSERT_TRUE(parser.IsEnd());
+
+  parser.SetBackend(TokenParser::FileParser::kBackendStream);
+  parser.SetFile(kTmpFilename);
+  ASSERT_FALSE(parser.IsMapped());
+  ASSERT_EQ(parser.NextWord(), "word");
+
+  std::remove(kTmpFilename.c_str());
+}
+
+TEST(FileParserMmap, NotRegularFile) {
+  TokenParser::FileParser parser;
+  parser.SetBackend(TokenParser::FileParser::kBackendMmap);
+  parser.SetFile("/dev/null");
+  ASSERT_FALSE(parser.IsMapped());
+  ASSERT_EQ(parser.NextWord(), "");
+  ASSERT_TRUE(parser.IsEnd());
+
+  parser.SetFile(".tmp_token_parser_test_no_such_file.txt");
+  ASSERT_FALSE(parser.IsMapped());
+  ASSERT_TRUE(parser.IsEnd());
+}
+
+TEST(StreamParserBuffSize, SameAsStringParser) {
+  std::string parsing_str;
+  for (int i = 0; i < 200; ++i) {
+    parsing_str += "word" + std::to_string(i) + (i % 3 ? " " : "\n\t");
+    parsing_str += std::to_string(i * 7919 % 1000) + ".5e" +
+                   std::to_string(i % 5) + ";";
+    parsing_str += i % 7 ? "id" : "'qouted\n " + std::to_string(i) + "' ";
+  }
+
+  for (std::string delims : {"\n \f\r\t\v;'", ";'"}) {
+    TokenParser::Settings settings;
+    settings.SetTokenIds({{0, "id"}, {1, ";"}});
+    settings.SetWordDelim(delims);
+    settings.SetWordMaySurrondedByQoutes(true);
+
+    TokenParser::StringParser str_parser(settings, &parsing_str);
+    std::vector<std::string> expected;
+    while (!str_parser.IsEnd()) {
+      expected.push_back(str_parser.NextWord());
+      expected.push_back(std::to_string(str_parser.NextFloat().GetFloat()));
+      expected.push_back(std::to_string(str_parser.NextId().GetId()));
+    }
+
+    for (std::size_t buff_size : {1, 2, 3, 7, 64, 1 << 16}) {
+      std::stringstream ss(parsing_str);
+      TokenParser::StreamParser<char> parser(settings, &ss);
+      parser.SetBuffSize(buff_size);
+      std::vector<std::string> res;
+      while (!parser.IsEnd()) {
+        res.push_back(parser.NextWord());
+        res.push_back(std::to_string(parser.NextFloat().GetFloat()));
+        res.push_back(std::to_string(parser.NextId().GetId()));
+      }
+      ASSERT_EQ(res, expected) << delims << " " << buff_size;
+    }
+  }
+}
+
+TEST(StreamParserBuffSize, IdWithSpaceNotCut) {
+  std::string parsing_str;
+  for (int i = 0; i < 200; ++i) {
+    parsing_str += i % 3 ? "end if " : "end\nif ";
+    parsing_str += i % 5 ? "x" + std::to_string(i) + " " : "end  ";
+  }
+
+  TokenParser::Settings settings;
+  settings.SetTokenIds({{0, "end"}, {1, "if"}, {2, "end if"}});
+  settings.SetTokenIdIsFullWord(true);
+  settings.SetTokenIdLongestMatch(true);
+
+  auto lexeme_str = [](const TokenParser::Lexeme& lexeme) {
+    if (lexeme.GetToken().IsId())
+      return "#" + std::to_string(lexeme.GetToken().GetId());
+    return std::string(lexeme.GetText());
+  };
+
+  TokenParser::StringParser str_parser(settings, &parsing_str);
+  std::vector<std::string> expected;
+  while (!str_parser.IsEnd())
+    expected.push_back(lexeme_str(str_parser.NextAny()));
+  ASSERT_EQ(expected[3], "#2");
+
+  for (std::size_t buff_size : {1, 2, 3, 4, 5, 7, 64, 1 << 16}) {
+    std::stringstream ss(parsing_str);
+    TokenParser::StreamParser<char> parser(settings, &ss);
+    parser.SetBuffSize(buff_size);
+    std::vector<std::string> res;
+    // IsEnd() is false until the stream is read to the end.
+    for (auto lexeme = parser.NextAny(); !lexeme.IsEnd();
+         lexeme = parser.NextAny())
+      res.push_back(lexeme_str(lexeme));
+    ASSERT_EQ(res, expected) << buff_size;
+  }
+}
+
+TEST(StreamParserBuffSize, LongRunWithoutBoundary) {
+  // Only the new block is searched for a boundary, a long word is read in
+  // linear time.
+  std::string parsing_str = std::string(1 << 20, 'a') + " end";
+  std::stringstream ss(parsing_str);
+  TokenParser::StreamParser<char> parser(&ss);
+  parser.SetBuffSize(16);
+  ASSERT_EQ(parser.NextWordView().length(), std::size_t(1) << 20);
+  ASSERT_EQ(parser.NextWord(), "end");
+}
+
+TEST(StreamParserBuffSize, EveryBoundaryInId) {
+  // Every space is inside an id, the block is cut at one anyway after a
+  // block of lookahead instead of buffering the whole stream.
+  std::string parsing_str;
+  for (int i = 0; i < 1 << 14; ++i) parsing_str += "a ";
+  TokenParser::Settings settings;
+  settings.SetTokenIds({{0, "a a"}});
+  std::stringstream ss(parsing_str);
+  TokenParser::StreamParser<char> parser(settings, &ss);
+  parser.SetBuffSize(16);
+  std::size_t chars = 0;
+  for (auto lexeme = parser.NextAny(); !lexeme.IsEnd();
+       lexeme = parser.NextAny()) {
+    ASSERT_LT(parser.GetView().length(), std::size_t(64));
+    chars += lexeme.GetText().length();
+  }
+  ASSERT_GT(chars, parsing_str.length() / 2);
+}
+
+TEST(NextParsingStart, CacheInvalidated) {
+  std::string str = "  a  b";
+  TokenParser::StringParser parser(&str);
+  ASSERT_FALSE(parser.IsEnd());
+  ASSERT_EQ(parser.NextWord(), "a");
+
+  // The same chars with other space chars.
+  parser.SetI(0);
+  ASSERT_FALSE(parser.IsEnd());
+  TokenParser::Settings no_spaces = parser.GetSettings();
+  no_spaces.SetSpaceChars("");
+  parser.SetSettings(std::move(no_spaces));
+  ASSERT_EQ(parser.NextWord(), " ");
+  parser.SetI(0);
+  ASSERT_FALSE(parser.IsEnd());
+  TokenParser::Settings settings;
+  parser.SetSettings(settings);
+  ASSERT_EQ(parser.NextWord(), "a");
+
+  // Other chars at the same address.
+  parser.SetI(0);
+  ASSERT_FALSE(parser.IsEnd());
+  str[0] = 'c';
+  parser.SetStr(&str);
+  ASSERT_EQ(parser.NextWord(), "c");
+  ASSERT_EQ(parser.NextWord(), "a");
+  ASSERT_EQ(parser.NextWord(), "b");
+  ASSERT_TRUE(parser.IsEnd());
+}
+
+TEST(NextParsingStart, RewindAfterChange) {
+  std::string str = "  ab";
+  TokenParser::StringParser parser(&str);
+  ASSERT_FALSE(parser.IsEnd());
+
+  // Other chars at the same address and of the same length.
+  str = "cd  ";
+  parser.SetI(0);
+  ASSERT_EQ(parser.NextWord(), "cd");
+  ASSERT_TRUE(parser.IsEnd());
+
+  str = "  ef";
+  parser.SetI(0);
+  ASSERT_FALSE(parser.IsEnd());
+  str = "gh  ";
+  parser.SetI(1);
+  ASSERT_EQ(parser.NextWord(), "h");
+}
+
+template <typename Parser>
+std::vector<std::string> NextWithPeeks(Parser& parser, bool peek) {
+  std::vector<std::string> res;
+  for (int k = 0; !parser.IsEnd(); ++k) {
+    // Other peeks before, so a Next* takes the lexeme peeked by another one.
+    if (peek && k % 5 == 1) parser.PeekAny();
+    if (peek && k % 5 == 2) parser.PeekId();
+    if (peek && k % 5 == 3) parser.PeekWord();
+
+    switch (k % 4) {
+      case 0: {
+        TokenParser::Lexeme peeked;
+        if (peek) peeked = parser.PeekAny();
+        TokenParser::Lexeme lexeme = parser.NextAny();
+        if (peek) {
+          EXPECT_EQ(peeked, lexeme);
+        }
+        res.push_back(std::string(lexeme.GetText()));
+        break;
+      }
+      case 1: {
+        TokenParser::Token peeked;
+        if (peek) peeked = parser.PeekId();
+        TokenParser::Token id = parser.NextId();
+        if (peek) {
+          EXPECT_EQ(peeked, id);
+        }
+        res.push_back(std::to_string(id.IsNull() ? -1 : id.GetId()));
+        break;
+      }
+      case 2: {
+        std::string peeked = peek ? parser.PeekWord() : "";
+        std::string word = parser.NextWord();
+        if (peek) {
+          EXPECT_EQ(peeked, word);
+        }
+        res.push_back(word);
+        break;
+      }
+      default: {
+        TokenParser::Token id = parser.NextThisId(0);
+        res.push_back(std::to_string(id.IsNull() ? -1 : id.GetId()));
+        if (id.IsNull()) res.push_back(parser.NextWord());
+        break;
+      }
+    }
+  }
+  return res;
+}
+
+TEST(Peek, SameAsNext) {
+  std::string parsing_str;
+  for (int i = 0; i < 200; ++i) {
+    parsing_str += "word" + std::to_string(i) + " " + std::to_string(i) +
+                   ".5;" + (i % 3 ? "id;" : "idx ");
+    parsing_str += i % 7 ? "id " : "'qouted\n " + std::to_string(i) + "' ";
+  }
+
+  TokenParser::Settings settings;
+  settings.SetTokenIds({{0, "id"}, {1, ";"}, {2, "'qouted\n 7'"}});
+  settings.SetWordDelim(settings.GetWordDelimChars() + ";'");
+  settings.SetWordMaySurrondedByQoutes(true);
+
+  TokenParser::StringParser str_parser(settings, &parsing_str);
+  std::vector<std::string> expected = NextWithPeeks(str_parser, false);
+  str_parser.SetStr(&parsing_str);
+  ASSERT_EQ(NextWithPeeks(str_parser, true), expected);
+
+  // Peeking reads the same blocks as parsing does, a stream parser may see
+  // the end of the stream one call later than a string parser.
+  for (std::size_t buff_size : {1, 2, 3, 7, 64, 1 << 16}) {
+    std::stringstream ss(parsing_str);
+    TokenParser::StreamParser<char> parser(settings, &ss);
+    parser.SetBuffSize(buff_size);
+    std::vector<std::string> stream_expected = NextWithPeeks(parser, false);
+    std::stringstream ss2(parsing_str);
+    parser.SetStream(&ss2);
+    ASSERT_EQ(NextWithPeeks(parser, true), stream_expected) << buff_size;
+  }
+
+  const std::string kTmpFilename = ".tmp_token_parser_test_peek.txt";
+  std::ofstream file(kTmpFilename);
+  file << parsing_str;
+  file.close();
+  for (auto backend : {TokenParser::FileParser::kBackendStream,
+                       TokenParser::FileParser::kBackendMmap}) {
+    TokenParser::FileParser parser(settings);
+    parser.SetBackend(backend);
+    parser.SetBuffSize(5);
+    parser.SetFile(kTmpFilename);
+    std::vector<std::string> file_expected = NextWithPeeks(parser, false);
+    parser.SetFile(kTmpFilename);
+    ASSERT_EQ(NextWithPeeks(parser, true), file_expected) << backend;
+  }
+  std::remove(kTmpFilename.c_str());
+}
+
+TEST(Peek, Rewind) {
+  TokenParser::Settings settings;
+  settings.SetTokenIds({{0, "int"}, {1, "in"}});
+  settings.SetTokenIdIsFullWord(false);
+  std::string str = "  int x";
+  TokenParser::StringParser parser(settings, &str);
+
+  ASSERT_EQ(parser.PeekId().GetId(), 0);
+  ASSERT_EQ(parser.GetI(), std::size_t(0));
+  ASSERT_EQ(parser.PeekWord(), "int");
+  ASSERT_EQ(parser.NextThisId(1).GetId(), 1);
+  ASSERT_EQ(parser.GetI(), std::size_t(4));
+
+  parser.SetI(0);
+  ASSERT_EQ(parser.NextId().GetId(), 0);
+  ASSERT_EQ(parser.PeekAny().GetText(), "x");
+  ASSERT_EQ(parser.NextWord(), "x");
+  ASSERT_TRUE(parser.IsEnd());
+  ASSERT_TRUE(parser.PeekAny().IsEnd());
+  ASSERT_TRUE(parser.PeekId().IsNull());
+
+  // The chars are changed at the same address.
+  parser.SetI(0);
+  ASSERT_EQ(parser.PeekWord(), "int");
+  str[2] = 'o';
+  parser.SetStr(&str);
+  ASSERT_TRUE(parser.PeekId().IsNull());
+  ASSERT_EQ(parser.NextWord(), "ont");
+
+  // The chars are changed in place and rewound by SetI().
+  str = "  int x";
+  parser.SetStr(&str);
+  ASSERT_EQ(parser.PeekId().GetId(), 0);
+  ASSERT_EQ(parser.PeekAny().GetToken().GetId(), 0);
+  str[2] = 'o';
+  parser.SetI(0);
+  ASSERT_TRUE(parser.NextId().IsNull());
+  ASSERT_EQ(parser.NextAny().GetText(), "ont");
+  str[2] = 'i';
+  parser.SetI(0);
+  ASSERT_EQ(parser.PeekWord(), "int");
+  str[3] = 'x';
+  parser.SetI(0);
+  ASSERT_EQ(parser.NextWord(), "ixt");
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "../include/token_parser/lexeme.h"
+#include "../include/token_parser/parallel_file_parser.h"
+#include "../include/token_parser/string_parser.h"
+#include "../include/token_parser/token_buffer.h"
+
+using TokenParser::ParallelFileParser;
+using TokenParser::TokenBuffer;
+
+TEST(ParallelFileParser, SameAsStringParser) {
+  std::string str;
+  for (int i = 0; i < 300; ++i) {
+    str += "word" + std::to_string(i) + (i % 3 ? " " : "\n\t");
+    str += std::to_string(i * 7919 % 1000) + ".5e" + std::to_string(i % 5);
+    str += i % 2 ? ";-" + std::to_string(i) + " " : "; ";
+    str += i % 7 ? "id " : "'qouted\n " + std::to_string(i) + " x' ";
+  }
+  str += "'not closed qoute word";
+
+  const std::string kTmpFilename = ".tmp_token_parser_test_parallel.txt";
+  std::ofstream file(kTmpFilename);
+  file << str;
+  file.close();
+
+  TokenParser::Settings settings;
+  settings.SetTokenIds({{0, "id"}, {1, ";"}});
+  settings.SetWordDelim(settings.GetWordDelimChars() + ";'");
+  settings.SetWordMaySurrondedByQoutes(true);
+
+  TokenParser::StringParser str_parser(settings, &str);
+  TokenBuffer expected;
+  expected.SetTrackPositions(true);
+  str_parser.NextBatch(expected, str.length());
+
+  ParallelFileParser parser(settings, kTmpFilename);
+  ASSERT_EQ(parser.GetView(), str);
+  for (std::size_t chunk_size : {1, 2, 3, 7, 64, 1 << 22}) {
+    for (std::size_t threads : {1, 2, 5}) {
+      parser.SetChunkSize(chunk_size);
+      parser.SetThreads(threads);
+      TokenBuffer res;
+      ASSERT_EQ(parser.Tokenize(res), expected.Size());
+      ASSERT_EQ(res.Size(), expected.Size());
+      for (TokenBuffer::size_type i = 0; i < res.Size(); ++i) {
+        ASSERT_EQ(res.GetToken(i), expected.GetToken(i)) << chunk_size;
+        ASSERT_EQ(res.GetOffset(i), expected.GetOffset(i)) << chunk_size;
+        ASSERT_EQ(res.GetLength(i), expected.GetLength(i)) << chunk_size;
+        ASSERT_EQ(res.IsWord(i), expected.IsWord(i)) << chunk_size;
+        if (res.IsWord(i)) {
+          ASSERT_EQ(res.GetWord(i), expected.GetWord(i));
+        }
+      }
+
+      // The lexemes are appended after the lexemes of the buffer.
+      TokenBuffer tracked;
+      tracked.SetTrackPositions(true);
+      tracked.PushBack(TokenParser::Lexeme("first", 0));
+      ASSERT_EQ(parser.Tokenize(tracked), expected.Size());
+      ASSERT_EQ(tracked.Size(), expected.Size() + 1);
+      ASSERT_EQ(tracked.GetWord(0), "first");
+      for (TokenBuffer::size_type i = 0; i < expected.Size(); ++i) {
+        ASSERT_EQ(tracked.GetPosition(i + 1), expected.GetPosition(i))
+            << chunk_size << " " << i;
+        if (expected.IsWord(i)) {
+          ASSERT_EQ(tracked.GetWord(i + 1), expected.GetWord(i));
+        }
+      }
+    }
+  }
+
+  std::remove(kTmpFilename.c_str());
+}
+
+TEST(ParallelFileParser, NotRegularFile) {
+  ParallelFileParser parser("/dev/null");
+  TokenBuffer buffer;
+  ASSERT_EQ(parser.Tokenize(buffer), TokenBuffer::size_type(0));
+
+  parser.SetFile(".tmp_token_parser_test_no_such_file.txt");
+  ASSERT_EQ(parser.GetView(), "");
+  ASSERT_EQ(parser.Tokenize(buffer), TokenBuffer::size_type(0));
+}
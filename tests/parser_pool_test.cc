@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../include/token_parser/file_parser.h"
+#include "../include/token_parser/parser_pool.h"
+#include "../include/token_parser/stream_parser.h"
+#include "../include/token_parser/string_parser.h"
+
+using TokenParser::ParserPool;
+
+TEST(ParserReset, KeepsBuffer) {
+  std::string str(1000, 'a');
+  std::stringstream ss(str);
+  TokenParser::StreamParser<char> parser(&ss);
+  ASSERT_EQ(parser.NextWord(), str);
+  std::size_t capacity = parser.GetStr()->capacity();
+  const char* data = parser.GetStr()->data();
+
+  parser.Reset();
+  ASSERT_TRUE(parser.IsEnd());
+  ASSERT_EQ(parser.GetStream(), nullptr);
+  ASSERT_EQ(parser.GetStr()->capacity(), capacity);
+
+  std::stringstream ss2("word 12");
+  parser.SetStream(&ss2);
+  ASSERT_EQ(parser.NextWord(), "word");
+  ASSERT_EQ(parser.GetStr()->data(), data);
+  ASSERT_EQ(parser.NextInt().GetInt(), 12);
+
+  parser.ShrinkToFit();
+  ASSERT_LT(parser.GetStr()->capacity(), capacity);
+  ASSERT_TRUE(parser.IsEnd());
+
+  TokenParser::StringParser str_parser(&str);
+  str_parser.Reset();
+  ASSERT_TRUE(str_parser.IsEnd());
+  ASSERT_EQ(str_parser.GetI(), std::size_t(0));
+}
+
+TEST(ParserPool, Reuse) {
+  TokenParser::Settings settings;
+  settings.SetTokenIds({{0, "id"}});
+  ParserPool<TokenParser::StreamParser<char>> pool(settings);
+  ASSERT_EQ(pool.GetIdleCount(), std::size_t(0));
+
+  TokenParser::StreamParser<char>* first = nullptr;
+  {
+    auto parser = pool.Acquire();
+    ASSERT_TRUE(parser);
+    first = parser.Get();
+    std::stringstream ss("id word");
+    parser->SetStream(&ss);
+    ASSERT_EQ(parser->NextId().GetId(), 0);
+    TokenParser::Settings changed = parser->GetSettings();
+    changed.SetTokenIds({{1, "word"}});
+    parser->SetSettings(std::move(changed));
+    ASSERT_EQ(parser->NextId().GetId(), 1);
+  }
+  ASSERT_EQ(pool.GetIdleCount(), std::size_t(1));
+
+  auto parser = pool.Acquire();
+  ASSERT_EQ(parser.Get(), first);
+  ASSERT_EQ(pool.GetIdleCount(), std::size_t(0));
+  ASSERT_TRUE(parser->IsEnd());
+  ASSERT_EQ(parser->GetCompiledSettings(), pool.GetCompiledSettings());
+
+  auto second = pool.Acquire();
+  ASSERT_NE(second.Get(), first);
+  parser.Release();
+  ASSERT_FALSE(parser);
+  pool.SetMaxIdle(1);
+  second.Release();
+  ASSERT_EQ(pool.GetIdleCount(), std::size_t(1));
+}
+
+TEST(ParserPool, Threads) {
+  ParserPool<TokenParser::StringParser> pool;
+  std::vector<std::thread> threads;
+  std::vector<int> sums(4, 0);
+  for (std::size_t t = 0; t < sums.size(); ++t) {
+    threads.emplace_back([&pool, &sums, t]() {
+      for (int i = 0; i < 100; ++i) {
+        std::string str = std::to_string(i) + " 1";
+        auto parser = pool.Acquire();
+        parser->SetStr(&str);
+        sums[t] += static_cast<int>(parser->NextInt().GetInt());
+        sums[t] += static_cast<int>(parser->NextInt().GetInt());
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  for (int sum : sums) ASSERT_EQ(sum, 4950 + 100);
+  ASSERT_LE(pool.GetIdleCount(), sums.size());
+}
+
+TEST(ParserPool, FileParser) {
+  const std::string kTmpFilename = ".tmp_token_parser_test_pool.txt";
+  std::ofstream file(kTmpFilename);
+  file << "word 12";
+  file.close();
+
+  ParserPool<TokenParser::FileParser> pool;
+  for (int i = 0; i < 3; ++i) {
+    auto parser = pool.Acquire();
+    parser->SetFile(kTmpFilename);
+    ASSERT_EQ(parser->NextWord(), "word");
+    ASSERT_EQ(parser->NextInt().GetInt(), 12);
+    ASSERT_TRUE(parser->IsEnd());
+  }
+  ASSERT_EQ(pool.GetIdleCount(), std::size_t(1));
+
+  std::remove(kTmpFilename.c_str());
+}
@@ -0,0 +1,274 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../include/token_parser/char_set.h"
+#include "../include/token_parser/file_parser.h"
+#include "../include/token_parser/line_counter.h"
+#include "../include/token_parser/parallel_file_parser.h"
+#include "../include/token_parser/position.h"
+#include "../include/token_parser/stream_parser.h"
+#include "../include/token_parser/string_parser.h"
+#include "../include/token_parser/token_buffer.h"
+
+namespace TokenParser {
+
+void PrintTo(const Position& position, std::ostream* os) {
+  *os << position.GetOffset() << ":" << position.GetLine() << ":"
+      << position.GetColumn();
+}
+
+}  // namespace TokenParser
+
+using TokenParser::CharSet;
+using TokenParser::LineCounter;
+using TokenParser::Position;
+
+namespace {
+
+/// @brief Position of str[offset] by scanning str from the begin.
+Position ScanPosition(const std::string& str, std::size_t offset) {
+  std::size_t line = 1;
+  std::size_t line_start = 0;
+  for (std::size_t i = 0; i < offset; ++i) {
+    if (str[i] != '\n') continue;
+    ++line;
+    line_start = i + 1;
+  }
+  return Position(offset, line, offset - line_start + 1);
+}
+
+/// @brief Positions of the starts of the lexemes and of i after them.
+template <typename Parser>
+std::vector<Position> LexemePositions(Parser& parser,
+                                      const std::string& str) {
+  std::vector<Position> res;
+  for (auto lexeme = parser.NextAny(); !lexeme.IsEnd();
+       lexeme = parser.NextAny())
+    res.push_back(parser.GetPosition(lexeme.GetStart()));
+  Position position = parser.GetPosition();
+  EXPECT_EQ(position, ScanPosition(str, position.GetOffset()));
+  return res;
+}
+
+/// @brief Lexemes over several lines, quoted words with newlines.
+std::string PositionsCorpus() {
+  std::string str;
+  for (int i = 0; i < 300; ++i) {
+    str += "word" + std::to_string(i) + (i % 3 ? " " : "\n");
+    str += i % 5 ? "12;" : "'qouted\n\n" + std::to_string(i) + "'\n";
+    str += i % 7 ? "\t" : "\n\n  ";
+  }
+  return str;
+}
+
+TokenParser::Settings PositionsSettings() {
+  TokenParser::Settings settings;
+  settings.SetTokenIds({{0, ";"}});
+  settings.SetWordDelim(settings.GetWordDelimChars() + ";'");
+  settings.SetWordMaySurrondedByQoutes(true);
+  return settings;
+}
+
+/// @brief Positions of the lexemes taken by batches of 7.
+template <typename Parser>
+std::vector<Position> BatchPositions(Parser& parser) {
+  TokenParser::TokenBuffer buffer;
+  buffer.SetTrackPositions(true);
+  while (parser.NextBatch(buffer, 7) != 0) {
+  }
+
+  std::vector<Position> res;
+  for (std::size_t i = 0; i < buffer.Size(); ++i) {
+    EXPECT_EQ(buffer.GetLines()[i], buffer.GetPosition(i).GetLine());
+    EXPECT_EQ(buffer.GetColumns()[i], buffer.GetPosition(i).GetColumn());
+    EXPECT_EQ(buffer.GetOffsets()[i], buffer.GetPosition(i).GetOffset());
+    res.push_back(buffer.GetPosition(i));
+  }
+  return res;
+}
+
+}  // namespace
+
+TEST(LineCounter, PositionAt) {
+  std::string str = "ab\ncd\n\nx";
+  LineCounter counter;
+  ASSERT_EQ(counter.PositionAt(str, 0), Position(0, 1, 1));
+  ASSERT_EQ(counter.PositionAt(str, 2), Position(2, 1, 3));
+  ASSERT_EQ(counter.PositionAt(str, 4), Position(4, 2, 2));
+  ASSERT_EQ(counter.PositionAt(str, 7), Position(7, 4, 1));
+  ASSERT_EQ(counter.PositionAt(str, 8), Position(8, 4, 2));
+  ASSERT_EQ(counter.PositionAt(str, 100), Position(8, 4, 2));
+  ASSERT_EQ(counter.PositionAt(str, 3), Position(3, 2, 1));
+
+  // The string continues a line of the source.
+  counter.Reset(Position(10, 3, 5));
+  ASSERT_EQ(counter.GetBase(), Position(10, 3, 5));
+  ASSERT_EQ(counter.PositionAt(str, 1), Position(11, 3, 6));
+  ASSERT_EQ(counter.PositionAt(str, 6), Position(16, 5, 1));
+}
+
+TEST(LineCounter, PositionsAt) {
+  std::string str;
+  for (int i = 0; i < 3000; ++i) str.push_back(i % 5 && i % 13 ? 'a' : '\n');
+
+  // Steps shorter, equal and longer than the 64 chars of the mask, the last
+  // offset goes back and past the end.
+  std::vector<std::size_t> offsets;
+  std::size_t i = 0;
+  for (std::size_t step : {0, 1, 3, 63, 64, 65, 200, 1, 2}) {
+    i += step;
+    offsets.push_back(i);
+  }
+  for (; i < str.size(); i += i % 7 + 1) offsets.push_back(i);
+  offsets.push_back(10);
+  offsets.push_back(str.size() + 5);
+
+  for (Position base : {Position(), Position(100, 7, 3)}) {
+    LineCounter expected_counter;
+    expected_counter.Reset(base);
+    LineCounter counter;
+    counter.Reset(base);
+    std::vector<std::size_t> source_offsets;
+    for (std::size_t offset : offsets)
+      source_offsets.push_back(base.GetOffset() + offset);
+
+    // The batch continues the positions asked before it.
+    ASSERT_EQ(counter.PositionAt(str, 2), expected_counter.PositionAt(str, 2));
+    std::vector<std::size_t> lines(offsets.size());
+    std::vector<std::size_t> columns(offsets.size());
+    counter.PositionsAt(str, source_offsets.data(), source_offsets.size(),
+                        lines.data(), columns.data());
+    for (std::size_t k = 0; k < offsets.size(); ++k) {
+      Position position = expected_counter.PositionAt(str, offsets[k]);
+      ASSERT_EQ(lines[k], position.GetLine()) << k;
+      ASSERT_EQ(columns[k], position.GetColumn()) << k;
+    }
+    ASSERT_EQ(counter.PositionAt(str, 2999),
+              expected_counter.PositionAt(str, 2999));
+  }
+}
+
+TEST(LineCounter, KernelsSameAsScalar) {
+  std::vector<CharSet::Kernel> kernels = {CharSet::kKernelSse2,
+                                          CharSet::kKernelAvx2};
+  std::string str;
+  for (int i = 0; i < 2000; ++i) str.push_back(i % 7 && i % 11 ? 'a' : '\n');
+  str += std::string(100, 'a') + std::string(40, '\n');
+
+  for (CharSet::Kernel kernel : kernels) {
+    if (!LineCounter::IsKernelSupported(kernel)) continue;
+
+    for (std::string::size_type i = 0; i < str.size(); i += 3) {
+      for (std::string::size_type len : {0, 1, 15, 16, 17, 33, 64, 300}) {
+        const char* first = str.data() + i;
+        const char* last = str.data() + std::min(str.size(), i + len);
+        const char* last_newline = nullptr;
+        const char* scalar_last_newline = nullptr;
+        ASSERT_EQ(
+            LineCounter::CountNewlines(first, last, last_newline, kernel),
+            LineCounter::CountNewlines(first, last, scalar_last_newline,
+                                       CharSet::kKernelScalar));
+        ASSERT_EQ(last_newline, scalar_last_newline);
+      }
+    }
+  }
+}
+
+TEST(Position, SameInAllParsers) {
+  std::string str = PositionsCorpus();
+  TokenParser::Settings settings = PositionsSettings();
+
+  TokenParser::StringParser str_parser(settings, &str);
+  std::vector<Position> expected;
+  for (auto lexeme = str_parser.NextAny(); !lexeme.IsEnd();
+       lexeme = str_parser.NextAny())
+    expected.push_back(ScanPosition(str, lexeme.GetStart()));
+
+  str_parser.SetStr(&str);
+  ASSERT_EQ(LexemePositions(str_parser, str), expected);
+  ASSERT_EQ(str_parser.GetPosition().GetOffset(), str_parser.GetI());
+  ASSERT_EQ(str_parser.GetPosition(5), ScanPosition(str, 5));
+
+  for (std::size_t buff_size : {1, 2, 3, 7, 64, 1 << 16}) {
+    std::stringstream ss(str);
+    TokenParser::StreamParser<char> parser(settings, &ss);
+    parser.SetBuffSize(buff_size);
+    ASSERT_EQ(LexemePositions(parser, str), expected) << buff_size;
+  }
+
+  const std::string kTmpFilename = ".tmp_token_parser_test_position.txt";
+  std::ofstream file(kTmpFilename);
+  file << str;
+  file.close();
+  for (auto backend : {TokenParser::FileParser::kBackendStream,
+                       TokenParser::FileParser::kBackendMmap}) {
+    TokenParser::FileParser parser(settings);
+    parser.SetBackend(backend);
+    parser.SetBuffSize(5);
+    parser.SetFile(kTmpFilename);
+    ASSERT_EQ(LexemePositions(parser, str), expected) << backend;
+  }
+  std::remove(kTmpFilename.c_str());
+}
+
+TEST(Position, TokenBuffer) {
+  std::string str = PositionsCorpus();
+  TokenParser::Settings settings = PositionsSettings();
+
+  TokenParser::StringParser str_parser(settings, &str);
+  std::vector<Position> expected;
+  for (auto lexeme = str_parser.NextAny(); !lexeme.IsEnd();
+       lexeme = str_parser.NextAny())
+    expected.push_back(ScanPosition(str, lexeme.GetStart()));
+
+  str_parser.SetStr(&str);
+  ASSERT_EQ(BatchPositions(str_parser), expected);
+
+  for (std::size_t buff_size : {1, 3, 64, 1 << 16}) {
+    std::stringstream ss(str);
+    TokenParser::StreamParser<char> parser(settings, &ss);
+    parser.SetBuffSize(buff_size);
+    ASSERT_EQ(BatchPositions(parser), expected) << buff_size;
+  }
+
+  const std::string kTmpFilename = ".tmp_token_parser_test_batch_pos.txt";
+  std::ofstream file(kTmpFilename);
+  file << str;
+  file.close();
+  for (auto backend : {TokenParser::FileParser::kBackendStream,
+                       TokenParser::FileParser::kBackendMmap}) {
+    TokenParser::FileParser parser(settings);
+    parser.SetBackend(backend);
+    parser.SetBuffSize(5);
+    parser.SetFile(kTmpFilename);
+    ASSERT_EQ(BatchPositions(parser), expected) << backend;
+  }
+
+  TokenParser::ParallelFileParser parallel_parser(settings, kTmpFilename);
+  parallel_parser.SetThreads(3);
+  parallel_parser.SetChunkSize(100);
+  TokenParser::TokenBuffer buffer;
+  buffer.SetTrackPositions(true);
+  ASSERT_EQ(parallel_parser.Tokenize(buffer), expected.size());
+  for (std::size_t i = 0; i < buffer.Size(); ++i)
+    ASSERT_EQ(buffer.GetPosition(i), expected[i]) << i;
+  std::remove(kTmpFilename.c_str());
+
+  // The lexemes appended without a position have line and column 0.
+  str_parser.SetStr(&str);
+  TokenParser::TokenBuffer untracked;
+  str_parser.NextBatch(untracked, 2);
+  untracked.SetTrackPositions(true);
+  untracked.PushBack(str_parser.NextAny());
+  ASSERT_EQ(untracked.GetPosition(0), Position(0, 0, 0));
+  ASSERT_EQ(untracked.GetPosition(2).GetLine(), std::size_t(0));
+  str_parser.NextBatch(untracked, 1);
+  ASSERT_EQ(untracked.GetPosition(3), expected[3]);
+}
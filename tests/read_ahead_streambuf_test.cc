@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../include/token_parser/file_parser.h"
+#include "../include/token_parser/read_ahead_streambuf.h"
+
+using TokenParser::FileParser;
+using TokenParser::ReadAheadStreambuf;
+
+TEST(ReadAheadStreambuf, SameAsSource) {
+  std::string str;
+  for (int i = 0; i < 5000; ++i) str += std::to_string(i * 7919 % 1000) + " ";
+
+  ReadAheadStreambuf buff;
+  ASSERT_FALSE(buff.IsOpen());
+  std::istream stream(&buff);
+  ASSERT_EQ(stream.get(), std::char_traits<char>::eof());
+
+  for (std::size_t buff_size : {1, 3, 64, 1 << 16}) {
+    for (std::size_t count : {0, 2, 5}) {
+      std::stringbuf source(str);
+      buff.Open(&source, buff_size, count);
+      ASSERT_TRUE(buff.IsOpen());
+      stream.clear();
+
+      std::string res((std::istreambuf_iterator<char>(stream)),
+                      std::istreambuf_iterator<char>());
+      ASSERT_EQ(res, str) << buff_size << " " << count;
+    }
+  }
+
+  // The thread waits for free blocks when it is stopped.
+  std::stringbuf source(str);
+  buff.Open(&source, 16, 2);
+  stream.clear();
+  char chars[10];
+  stream.read(chars, 10);
+  ASSERT_EQ(std::string(chars, 10), str.substr(0, 10));
+  buff.Close();
+  ASSERT_FALSE(buff.IsOpen());
+  ASSERT_EQ(stream.get(), std::char_traits<char>::eof());
+}
+
+TEST(FileParserReadAhead, SameAsStream) {
+  std::string str;
+  for (int i = 0; i < 3000; ++i) {
+    str += "word" + std::to_string(i) + (i % 3 ? " " : "\n");
+    str += std::to_string(i) + (i % 7 ? " " : " 'qouted\n word' ");
+  }
+
+  const std::string kTmpFilename = ".tmp_token_parser_test_read_ahead.txt";
+  std::ofstream file(kTmpFilename);
+  file << str;
+  file.close();
+
+  TokenParser::Settings settings;
+  settings.SetWordDelim(settings.GetWordDelimChars() + "'");
+  settings.SetWordMaySurrondedByQoutes(true);
+  FileParser stream_parser(settings);
+  FileParser parser(settings);
+  parser.SetBackend(FileParser::kBackendReadAhead);
+  std::vector<std::string> expected;
+  for (std::size_t buff_size : {1, 7, 64, 1 << 16}) {
+    // The same blocks are read by the stream backend.
+    stream_parser.SetBuffSize(buff_size);
+    stream_parser.SetFile(kTmpFilename);
+    expected.clear();
+    while (!stream_parser.IsEnd()) expected.push_back(stream_parser.NextWord());
+
+    for (std::size_t count : {2, 4}) {
+      parser.SetBuffSize(buff_size);
+      parser.SetReadAheadCount(count);
+      parser.SetFile(kTmpFilename);
+      std::vector<std::string> res;
+      while (!parser.IsEnd()) res.push_back(parser.NextWord());
+      ASSERT_EQ(res, expected) << buff_size << " " << count;
+    }
+  }
+
+  // Stopped in the middle of the file.
+  parser.SetBuffSize(16);
+  parser.SetFile(kTmpFilename);
+  ASSERT_EQ(parser.NextWord(), expected[0]);
+  parser.Reset();
+  ASSERT_TRUE(parser.IsEnd());
+  parser.SetFile(kTmpFilename);
+  ASSERT_EQ(parser.NextWord(), expected[0]);
+
+  parser.SetFile(".tmp_token_parser_test_no_such_file.txt");
+  ASSERT_TRUE(parser.IsEnd());
+
+  std::remove(kTmpFilename.c_str());
+}
@@ -1,8 +1,15 @@
 #include <gtest/gtest.h>
 
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "../include/token_parser/compiled_settings.h"
+#include "../include/token_parser/stream_parser.h"
 #include "../include/token_parser/string_parser.h"
 #include "tests.h"
 
+using TokenParser::CompiledSettings;
 using TokenParser::Settings;
 
 TEST(Settings, Common) {
@@ -13,6 +20,7 @@ TEST(Settings, Common) {
   std::string word_delim_chars = "asdasbbb";
   std::string word_delim_chars2 = "asdasbbb";
   bool token_id_is_full_word = false;
+  bool token_id_longest_match = true;
   bool word_may_surrounded_by_qoutes = true;
   Settings::AppropriateQuotes appropriate_quotes = {{'a', 'b'}};
   Settings::AppropriateQuotes appropriate_quotes2 = {{'a', 'b'}};
@@ -22,18 +30,21 @@ TEST(Settings, Common) {
   a.SetSpaceChars(space_chars);
   a.SetWordDelim(word_delim_chars);
   a.SetTokenIdIsFullWord(token_id_is_full_word);
+  a.SetTokenIdLongestMatch(token_id_longest_match);
   a.SetWordMaySurrondedByQoutes(word_may_surrounded_by_qoutes);
   a.SetAppropriateQuotes(appropriate_quotes);
   b.SetTokenIds(std::move(token_ids2));
   b.SetSpaceChars(std::move(space_chars2));
   b.SetWordDelim(std::move(word_delim_chars2));
   b.SetTokenIdIsFullWord(token_id_is_full_word);
+  b.SetTokenIdLongestMatch(token_id_longest_match);
   b.SetWordMaySurrondedByQoutes(word_may_surrounded_by_qoutes);
   b.SetAppropriateQuotes(std::move(appropriate_quotes2));
   c.GetTokenIds() = token_ids;
   c.GetSpaceChars() = space_chars;
   c.GetWordDelimChars() = word_delim_chars;
   c.SetTokenIdIsFullWord(token_id_is_full_word);
+  c.SetTokenIdLongestMatch(token_id_longest_match);
   c.SetWordMaySurrondedByQoutes(word_may_surrounded_by_qoutes);
   c.GetAppropriateQuotes() = appropriate_quotes;
 
@@ -51,3 +62,81 @@ TEST(Settings, Common) {
   ASSERT_TRUE(SettingsEq(a, smove));
   ASSERT_TRUE(SettingsEq(a, omove));
 }
+
+TEST(CompiledSettings, Shared) {
+  Settings settings;
+  settings.SetTokenIds({{0, "int"}, {1, "="}});
+  settings.SetWordDelim(settings.GetWordDelimChars() + "=");
+  CompiledSettings::Ptr compiled = CompiledSettings::Compile(settings);
+  ASSERT_TRUE(SettingsEq(compiled->GetSettings(), settings));
+
+  std::string str = "int a=1";
+  TokenParser::StringParser a(compiled, &str);
+  TokenParser::StringParser b(compiled, &str);
+  std::stringstream ss(str);
+  TokenParser::StreamParser<char> c(compiled, &ss);
+  ASSERT_EQ(a.GetCompiledSettings(), compiled);
+  ASSERT_EQ(b.GetCompiledSettings(), compiled);
+  ASSERT_EQ(c.GetCompiledSettings(), compiled);
+  ASSERT_EQ(a.NextId().GetId(), 0);
+  ASSERT_EQ(c.NextId().GetId(), 0);
+
+  // The changed copy is committed to this parser only.
+  Settings changed = b.GetSettings();
+  changed.SetTokenIds({{0, "a"}});
+  b.SetSettings(std::move(changed));
+  ASSERT_NE(b.GetCompiledSettings(), compiled);
+  ASSERT_EQ(b.NextId().GetId(), 0);
+  ASSERT_TRUE(b.NextId().IsNull());
+  ASSERT_EQ(b.NextWord(), "int");
+  ASSERT_TRUE(SettingsEq(compiled->GetSettings(), settings));
+  ASSERT_EQ(a.NextWord(), "a");
+  ASSERT_EQ(a.NextId().GetId(), 1);
+
+  // The compiled settings are never changed, even if no other parser
+  // shares them: the change is compiled to new ones.
+  CompiledSettings::Ptr kept = b.GetCompiledSettings();
+  changed = b.GetSettings();
+  changed.SetTokenIdIsFullWord(false);
+  b.SetSettings(changed);
+  ASSERT_NE(b.GetCompiledSettings(), kept);
+  ASSERT_TRUE(kept->GetSettings().GetTokenIdIsFullWord());
+  ASSERT_FALSE(b.GetCompiledSettings()->GetSettings().GetTokenIdIsFullWord());
+
+  TokenParser::StringParser d(b);
+  ASSERT_EQ(d.GetCompiledSettings(), b.GetCompiledSettings());
+  changed.SetTokenIdIsFullWord(true);
+  d.SetSettings(changed);
+  ASSERT_FALSE(b.GetSettings().GetTokenIdIsFullWord());
+  ASSERT_TRUE(d.GetSettings().GetTokenIdIsFullWord());
+}
+
+TEST(CompiledSettings, ReadKeepsShared) {
+  std::string str = "ab cd";
+  Settings settings;
+  settings.SetTokenIds({{0, "ab"}});
+  CompiledSettings::Ptr compiled = CompiledSettings::Compile(settings);
+  TokenParser::StringParser a(compiled, &str);
+
+  // Reading the settings neither copies nor compiles them, so a copy of
+  // the parser still shares them.
+  ASSERT_EQ(&a.GetSettings(), &compiled->GetSettings());
+  ASSERT_EQ(a.NextId().GetId(), 0);
+  ASSERT_EQ(a.GetCompiledSettings(), compiled);
+  TokenParser::StringParser b(a);
+  ASSERT_EQ(b.GetCompiledSettings(), compiled);
+  ASSERT_EQ(b.NextWord(), "cd");
+}
+
+TEST(CompiledSettings, Default) {
+  TokenParser::StringParser a;
+  TokenParser::StringParser b;
+  ASSERT_EQ(a.GetCompiledSettings(), CompiledSettings::GetDefault());
+  ASSERT_EQ(b.GetCompiledSettings(), CompiledSettings::GetDefault());
+  Settings changed = a.GetSettings();
+  changed.SetSpaceChars(" ");
+  a.SetSettings(std::move(changed));
+  ASSERT_NE(a.GetCompiledSettings(), CompiledSettings::GetDefault());
+  ASSERT_TRUE(SettingsEq(CompiledSettings::GetDefault()->GetSettings(),
+                         Settings()));
+}
@@ -51,6 +51,7 @@ bool SettingsEq(const TokenParser::Settings& a,
   if (a.GetSpaceChars() != b.GetSpaceChars()) return false;
   if (a.GetWordDelimChars() != b.GetWordDelimChars()) return false;
   if (a.GetTokenIdIsFullWord() != b.GetTokenIdIsFullWord()) return false;
+  if (a.GetTokenIdLongestMatch() != b.GetTokenIdLongestMatch()) return false;
   if (a.GetWordMaySurrondedByQoutes() != b.GetWordMaySurrondedByQoutes())
     return false;
   return true;
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../include/token_parser/stream_parser.h"
+#include "../include/token_parser/string_parser.h"
+#include "../include/token_parser/token_buffer.h"
+
+using TokenParser::Token;
+using TokenParser::TokenBuffer;
+
+TEST(TokenBuffer, Common) {
+  std::string str = "int x = -12 3.5 7 word";
+  TokenParser::Settings settings;
+  settings.SetTokenIds({{0, "int"}, {1, "="}});
+  TokenParser::StringParser parser(settings, &str);
+
+  TokenBuffer buffer;
+  ASSERT_TRUE(buffer.Empty());
+  ASSERT_EQ(parser.NextBatch(buffer, 4), TokenBuffer::size_type(4));
+  ASSERT_EQ(parser.NextBatch(buffer, 100), TokenBuffer::size_type(3));
+  ASSERT_EQ(buffer.Size(), TokenBuffer::size_type(7));
+
+  std::vector<Token> expected = {
+      Token(0),   Token(),  Token(1), Token(Token::int_type(-12)),
+      Token(3.5), Token(Token::uint_type(7)), Token()};
+  std::vector<Token> tokens(buffer.begin(), buffer.end());
+  ASSERT_EQ(tokens, expected);
+
+  ASSERT_EQ(buffer.GetType(1), Token::Type::kTypeNull);
+  ASSERT_TRUE(buffer.IsWord(1));
+  ASSERT_EQ(buffer.GetWord(1), "x");
+  ASSERT_TRUE(buffer.IsWord(6));
+  ASSERT_EQ(buffer.GetWord(6), "word");
+  ASSERT_FALSE(buffer.IsWord(3));
+  ASSERT_EQ(buffer.GetTypes()[5], Token::Type::kTypeUint);
+  ASSERT_EQ(buffer.GetPayloads()[5], TokenBuffer::payload_type(7));
+
+  std::vector<std::string> texts = {"int", "x", "=", "-12",
+                                    "3.5", "7", "word"};
+  for (TokenBuffer::size_type i = 0; i < buffer.Size(); ++i) {
+    ASSERT_EQ(buffer.GetOffsets()[i], buffer.GetOffset(i));
+    ASSERT_EQ(buffer.GetLengths()[i], buffer.GetLength(i));
+    ASSERT_EQ(str.substr(buffer.GetOffset(i), buffer.GetLength(i)), texts[i]);
+  }
+
+  buffer.Clear();
+  ASSERT_TRUE(buffer.Empty());
+}
+
+TEST(TokenBuffer, StreamOffsets) {
+  std::string str;
+  for (int i = 0; i < 500; ++i)
+    str += "word" + std::to_string(i) + (i % 3 ? " " : "\n") +
+           std::to_string(i) + " ";
+
+  TokenParser::StreamParser<char> parser;
+  std::stringstream ss(str);
+  parser.SetStream(&ss);
+  parser.SetBuffSize(7);
+  TokenBuffer buffer;
+  while (parser.NextBatch(buffer, 16) != 0) {
+  }
+
+  ASSERT_EQ(buffer.Size(), TokenBuffer::size_type(1000));
+  for (TokenBuffer::size_type i = 0; i < buffer.Size(); ++i) {
+    std::string text = str.substr(buffer.GetOffset(i), buffer.GetLength(i));
+    if (buffer.IsWord(i)) {
+      ASSERT_EQ(text, buffer.GetWord(i));
+    } else {
+      ASSERT_EQ(text, std::to_string(buffer.GetToken(i).GetUint()));
+    }
+  }
+}
@@ -440,6 +440,43 @@ TEST_P(TestTokenParserTokenSeq, Common) {
   }
 }
 
+TEST_P(TestTokenParserTokenSeq, StringParserView) {
+  int num_test = this->GetParam();
+  TestTokenParserTokenSeqData& test_data =
+      TestTokenParserTokenSeq::test_data_[num_test];
+
+  // The chars after the view must not be parsed.
+  const std::string& str = TestTokenParser::strs_[test_data.parsing_str_idx_];
+  std::string buff = str + "9.9e9";
+  TokenParser::StringParser parser(
+      TestTokenParser::parsers_[test_data.parser_idx_]);
+  parser.SetStr(buff.data(), str.size());
+  parser.SetI(test_data.i_);
+
+  TestTokenParserTokenSeqData::Seq seq =
+      TestTokenParserTokenSeqData::seqs_[test_data.seq_idx_];
+
+  for (auto i : seq) {
+    if (!i.is_token_) {
+      std::string res = parser.NextWord();
+      ASSERT_EQ(res, i.str_);
+      continue;
+    }
+
+    TokenParser::Token token;
+    if (i.token_.IsInt())
+      token = parser.NextInt();
+    else if (i.token_.IsUint())
+      token = parser.NextUint();
+    else if (i.token_.IsFloat())
+      token = parser.NextFloat();
+    else
+      token = parser.NextId();
+
+    ASSERT_EQ(token, i.token_);
+  }
+}
+
 TEST_P(TestTokenParserTokenSeq, FileParser) {
   int num_test = this->GetParam();
   TestTokenParserTokenSeqData& test_data =
@@ -480,6 +517,47 @@ TEST_P(TestTokenParserTokenSeq, FileParser) {
   std::remove(kTmpFilename.c_str());
 }
 
+TEST_P(TestTokenParserTokenSeq, FileParserMmap) {
+  int num_test = this->GetParam();
+  TestTokenParserTokenSeqData& test_data =
+      TestTokenParserTokenSeq::test_data_[num_test];
+
+  const std::string kTmpFilename = ".tmp_token_parser_token_seq_test.txt";
+  std::ofstream file(kTmpFilename);
+  file << TestTokenParser::strs_[test_data.parsing_str_idx_];
+  file.close();
+  TokenParser::FileParser parser;
+  parser.SetBackend(TokenParser::FileParser::kBackendMmap);
+  parser.SetSettings(
+      TestTokenParser::parsers_[test_data.parser_idx_].GetSettings());
+  parser.SetFile(kTmpFilename);
+
+  TestTokenParserTokenSeqData::Seq seq =
+      TestTokenParserTokenSeqData::seqs_[test_data.seq_idx_];
+
+  for (auto i : seq) {
+    if (!i.is_token_) {
+      std::string res = parser.NextWord();
+      ASSERT_EQ(res, i.str_);
+      continue;
+    }
+
+    TokenParser::Token token;
+    if (i.token_.IsInt())
+      token = parser.NextInt();
+    else if (i.token_.IsUint())
+      token = parser.NextUint();
+    else if (i.token_.IsFloat())
+      token = parser.NextFloat();
+    else
+      token = parser.NextId();
+
+    ASSERT_EQ(token, i.token_);
+  }
+
+  std::remove(kTmpFilename.c_str());
+}
+
 TEST_P(TestTokenParserTokenSeq, FileParserNextThisId) {
   int num_test = this->GetParam();
   TestTokenParserTokenSeqData& test_data =
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <cstring>
+
 #include "../include/token_parser/string_parser.h"
 
 using TokenParser::Token;
@@ -70,3 +72,12 @@ TEST(Token, Common) {
   ASSERT_EQ(d.GetType(), Token::Type::kTypeUint);
   ASSERT_EQ(d.GetUint(), Token::uint_type(10));
 }
+
+TEST(Token, Memcpy) {
+  Token tokens[] = {Token(), Token(Token::int_type(-1)),
+                    Token(Token::uint_type(2)), Token(Token::float_type(3.5)),
+                    Token(Token::id_type(4))};
+  Token copies[5];
+  std::memcpy(copies, tokens, sizeof(tokens));
+  for (int i = 0; i < 5; ++i) ASSERT_EQ(copies[i], tokens[i]);
+}